@@ -15,6 +15,10 @@ set(LE3D_BMPCACHE_SLOTS				1024		CACHE STRING "Maximum number of bitmaps in cach
 set(LE3D_MESHCACHE_SLOTS			1024		CACHE STRING "Maximum number of meshes in cache")
 mark_as_advanced(LE3D_BMPCACHE_SLOTS LE3D_MESHCACHE_SLOTS)
 
+# Mesh levels of detail
+set(LE3D_MESHLOD_MAX_LEVELS			8			CACHE STRING "Maximum number of levels in a mesh LOD chain")
+mark_as_advanced(LE3D_MESHLOD_MAX_LEVELS)
+
 # Wavefront object parser
 set(LE3D_OBJ_MAX_NAME				256			CACHE STRING "Wavefront object maximum name string length")
 set(LE3D_OBJ_MAX_LINE				1024		CACHE STRING "Wavefront object maximum file line length")
@@ -31,17 +35,32 @@ set(LE3D_RENDERER_FAR_DEFAULT		32768.0f	CACHE STRING "Default far clipping dista
 set(LE3D_RENDERER_FOV_DEFAULT		65.0f		CACHE STRING "Default field of view")
 option(LE3D_RENDERER_3DFRUSTRUM		"Use a 3D frustrum to clip triangles" On)
 option(LE3D_RENDERER_2DFRAME		"Use a 2D frame to clip triangles" Off)
+option(LE3D_RENDERER_GUARDBAND		"Use a guard band around the viewport to clip triangles" Off)
+set(LE3D_RENDERER_GUARDBAND_DEFAULT	4.0f		CACHE STRING "Default guard band size (ratio of the viewport size)")
+set(LE3D_RENDERER_THREADS			1			CACHE STRING "Default number of geometry threads (0 for one per processor)")
+set(LE3D_RENDERER_SPLIT				4096		CACHE STRING "Minimum number of triangles to split a mesh across threads")
+mark_as_advanced(LE3D_RENDERER_SPLIT)
 
 option(LE3D_RENDERER_INTRASTER "Enable fixed point or floating point rasterizing" Off)
+set(LE3D_RASTERIZER_THREADS			1			CACHE STRING "Default number of rasterizer threads (0 for one per processor)")
+set(LE3D_RASTERIZER_TILE			64			CACHE STRING "Size of the rasterizer screen tiles (multi-threaded rasterizing)")
+mark_as_advanced(LE3D_RASTERIZER_TILE)
+option(LE3D_RASTERIZER_STATS "Count the rasterizer pixel writes, spans and rejects (instrumented build)" Off)
 
-set(LE3D_TRILIST_MAX				50000		CACHE STRING "Maximum number of triangles in display list")
-set(LE3D_VERLIST_MAX				150000		CACHE STRING "Maximum number of vertexes in transformation buffer")
-mark_as_advanced(LE3D_TRILIST_MAX LE3D_VERLIST_MAX)
+set(LE3D_TRILIST_INIT				4096		CACHE STRING "Initial number of triangles in display list")
+set(LE3D_TRILIST_MAX				1000000		CACHE STRING "Maximum number of triangles in display list")
+set(LE3D_VERLIST_INIT				1024		CACHE STRING "Initial number of vertexes in transformation buffer")
+set(LE3D_VERLIST_MAX				1000000		CACHE STRING "Maximum number of vertexes in transformation buffer")
+set(LE3D_LISTS_SHRINK				300			CACHE STRING "Number of frames before shrinking an oversized list (0 to never shrink)")
+mark_as_advanced(LE3D_TRILIST_INIT LE3D_TRILIST_MAX LE3D_VERLIST_INIT LE3D_VERLIST_MAX LE3D_LISTS_SHRINK)
 
 # Performance optimizations
 option(LE3D_USE_SIMD "Use SIMD instructions & vectors" On)
 if(NOT(AMIGA))
     option(LE3D_USE_SSE2 "Use Intel SSE2 instructions" On)
+    option(LE3D_USE_AVX2 "Use Intel AVX2 instructions" Off)
+    option(LE3D_RASTERIZER_DISPATCH "Build every rasterizer filler backend and select one at runtime" Off)
+    option(LE3D_TEXTURE_TILING "Support textures stored in 4x4 pixel tiles (rasterizer addressing)" Off)
 else()
     option(LE3D_USE_AMMX "Use Apollo AMMX instructions" Off)
     option(LE3D_USE_SAGA_FB "Use Vampire direct framebuffer access" Off)
@@ -549,9 +549,40 @@ void LeBitmap::preMultiply()
 		mipmaps[l]->preMultiply();
 }
 
+/**
+	\fn void LeBitmap::classifyAlpha()
+	\brief Classify the alpha channel of an RGBA bitmap (and its mipmaps)
+
+	An opaque bitmap loses its RGBA flag, a bitmap with only transparent
+	and opaque pixels is flagged cutout (alpha tested instead of blended).
+*/
+void LeBitmap::classifyAlpha()
+{
+	size_t noPixels = tx * ty;
+	bool opaque = true;
+	bool binary = true;
+
+	LeColor * c = (LeColor *) data;
+	for (size_t i = 0; i < noPixels; i++) {
+		if (c->a != 0xFF) {
+			opaque = false;
+			if (c->a != 0) {binary = false; break;}
+		}
+		c++;
+	}
+
+	flags &= ~(LE_BITMAP_RGBA | LE_BITMAP_CUTOUT);
+	if (!opaque) flags |= binary ? LE_BITMAP_RGBA | LE_BITMAP_CUTOUT : LE_BITMAP_RGBA;
+
+	for (int l = 1; l < mmLevels; l++)
+		mipmaps[l]->classifyAlpha();
+}
+
 /**
 	\fn void LeBitmap::makeMipmaps()
 	\brief Generate mipmaps from the bitmap
+
+	The mipmaps of a cutout bitmap keep a binary alpha channel.
 */
 void LeBitmap::makeMipmaps()
 {
@@ -584,6 +615,7 @@ void LeBitmap::makeMipmaps()
 				int g = (s1->g + s2->g + s3->g + s4->g) >> 2;
 				int b = (s1->b + s2->b + s3->b + s4->b) >> 2;
 				int a = (s1->a + s2->a + s3->a + s4->a) >> 2;
+				if (flags & LE_BITMAP_CUTOUT) a = a >= 0x80 ? 0xFF : 0;
 				* p++ = LeColor(r, g, b, a);
 				o += 2;
 			}
@@ -597,3 +629,39 @@ void LeBitmap::makeMipmaps()
 		mipmaps[mmLevels++] = bmp;
 	}
 }
+
+/**
+	\fn void LeBitmap::tile()
+	\brief Reorder the bitmap (and its mipmaps) in tiles of 4x4 pixels
+
+	A tile fills a 64 bytes cache line: texture fetches stay close
+	in memory whatever the direction the spans walk the texture.
+	A tiled bitmap can only be used as a texture (blits expect rows).
+	Bitmaps smaller than a tile use tiles of their own size.
+*/
+void LeBitmap::tile()
+{
+	if (flags & LE_BITMAP_TILED) return;
+	if ((tx & (tx - 1)) != 0 || (ty & (ty - 1)) != 0)
+		return;
+
+	int tu = cmmin(txP2, 2);
+	int tv = cmmin(tyP2, 2);
+	int mu = (1 << tu) - 1;
+	int mv = (1 << tv) - 1;
+
+	LeColor * src = (LeColor *) data;
+	LeColor * tmp = new LeColor[tx * ty];
+	for (int y = 0; y < ty; y++) {
+		for (int x = 0; x < tx; x++) {
+			int i = (x & mu) + ((x & ~mu) << tv) + ((y & mv) << tu) + ((y & ~mv) << txP2);
+			tmp[i] = * src++;
+		}
+	}
+	memcpy(data, tmp, tx * ty * sizeof(LeColor));
+	delete[] tmp;
+
+	flags |= LE_BITMAP_TILED;
+	for (int l = 1; l < mmLevels; l++)
+		mipmaps[l]->tile();
+}
@@ -45,7 +45,9 @@
 typedef enum {
 	LE_BITMAP_RGB				= 0,	/**< Bitmap in 32bit RGB color format */
 	LE_BITMAP_RGBA				= 1,	/**< Bitmap in 32bit RGBA format */
-	LE_BITMAP_PREMULTIPLIED		= 2		/**< Bitmap in 32bit RGBA (alpha pre-multiplied) format */
+	LE_BITMAP_PREMULTIPLIED		= 2,	/**< Bitmap in 32bit RGBA (alpha pre-multiplied) format */
+	LE_BITMAP_TILED				= 4,	/**< Bitmap stored in 4x4 pixel tiles (texture only) */
+	LE_BITMAP_CUTOUT			= 8		/**< Bitmap alpha either transparent or opaque (alpha tested) */
 }LE_BITMAP_FLAGS;
 
 /*****************************************************************************/
@@ -73,7 +75,9 @@ public:
 	void deallocate();
 
 	void preMultiply();
+	void classifyAlpha();
 	void makeMipmaps();
+	void tile();
 
 	LeHandle context;		/**< Handle available for graphic contexts */
 	LeHandle bitmap;		/**< Handle available for bitmap */
@@ -51,7 +51,8 @@ LeBmpCache bmpCache;
 
 /*****************************************************************************/
 LeBmpCache::LeBmpCache() :
-	noSlots(0)
+	noSlots(0),
+	tiling(false)
 {
 	memset(cacheSlots, 0, sizeof(Slot) * LE_BMPCACHE_SLOTS);
 
@@ -89,6 +90,24 @@ void LeBmpCache::clean()
 	noSlots = 0;
 }
 
+/**
+	\fn void LeBmpCache::setTiling(bool enable)
+	\brief Store the next loaded bitmaps (and mipmaps) in 4x4 pixel tiles
+	\param[in] enable tiling enable state
+
+	Tiled bitmaps are faster textures when the spans walk the texture
+	vertically, but they cannot be blitted: load them separately.
+	The rasterizer addresses tiled textures if built with LE_TEXTURE_TILING.
+*/
+void LeBmpCache::setTiling(bool enable)
+{
+#if LE_TEXTURE_TILING == 1
+	tiling = enable;
+#else
+	tiling = false;
+#endif // LE_TEXTURE_TILING
+}
+
 /*****************************************************************************/
 /**
 	\fn LeBitmap * LeBmpCache::loadBMP(const char * path)
@@ -113,12 +132,25 @@ LeBitmap * LeBmpCache::loadBMP(const char * path)
 		return NULL;
 	}
 
+// Opaque, cutout or translucent
+	if (bitmap->flags & LE_BITMAP_RGBA)
+		bitmap->classifyAlpha();
+
 	bitmap->makeMipmaps();
 	cacheSlots[slot].flags |= LE_BMPCACHE_MIPMAPPED;
 
-	if (bitmap->flags & LE_BMPCACHE_RGBA) {
+	if (bitmap->flags & LE_BITMAP_RGBA) {
 		bitmap->preMultiply();
+		bitmap->classifyAlpha();
 		cacheSlots[slot].flags |= LE_BMPCACHE_RGBA;
+		if (bitmap->flags & LE_BITMAP_CUTOUT)
+			cacheSlots[slot].flags |= LE_BMPCACHE_CUTOUT;
+	}
+
+	if (tiling) {
+		bitmap->tile();
+		if (bitmap->flags & LE_BITMAP_TILED)
+			cacheSlots[slot].flags |= LE_BMPCACHE_TILED;
 	}
 
 	return bitmap;
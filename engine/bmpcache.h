@@ -48,6 +48,8 @@ typedef enum{
 	LE_BMPCACHE_RGBA				= 0x01,		/**< Bitmap in 32bit RGBA (alpha pre-multiplied) format */
 	LE_BMPCACHE_ANIMATION		= 0x02,		/**< Bitmap with animation (uses cursor & extra bitmaps) */
 	LE_BMPCACHE_MIPMAPPED		= 0x04,		/**< Bitmap with computed mipmaps */
+	LE_BMPCACHE_TILED			= 0x08,		/**< Bitmap stored in 4x4 pixel tiles (texture only) */
+	LE_BMPCACHE_CUTOUT			= 0x10,		/**< Bitmap alpha either transparent or opaque (alpha tested) */
 }LE_BMPCACHE_FLAGS;
 
 /*****************************************************************************/
@@ -62,6 +64,7 @@ public:
 	~LeBmpCache();
 
 	void clean();
+	void setTiling(bool enable);
 	
 	void loadDirectory(const char * path);
 	LeBitmap * loadBMP(const char * path);
@@ -87,6 +90,7 @@ public:
 
 	Slot cacheSlots[LE_BMPCACHE_SLOTS];			/**< Slots in cache */
 	int noSlots;							/**< Number of cacheSlots in cache */
+	bool tiling;							/**< Store the loaded bitmaps in tiles */
 
 private:
 	int createSlot(LeBitmap * bitmap, const char * path);
@@ -36,7 +36,16 @@ inline void LeRasterizer::fillFlatTexZC(int y, float x1, float x2, float w1, flo
 
 	int xb = (int)(x1);
 	int xe = (int)(x2 + 0.9999f);
-	if (xe > frame.tx) xe = frame.tx;
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) {
+		float t = (scissorX1 - x1) / (x2 - x1);
+		u1 += (u2 - u1) * t;
+		v1 += (v2 - v1) * t;
+		w1 += (w2 - w1) * t;
+		floatd = x2 - scissorX1;
+		xb = scissorX1;
+	}
+	if (xe <= xb) return;
 
 	uint8_t * p = (uint8_t *) (xb + y * frame.tx + pixels);
 	short shortd = xe - xb;
@@ -0,0 +1,163 @@
+/**
+	\file flattexalphazcfog.inc
+	\brief LightEngine 3D: Filler (avx2/float) - flat textured & alpha blended z-corrected scans with fog
+	\brief Intel x86 CPU (with AVX2) implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+inline void LeRasterizer::fillFlatTexAlphaZCFog(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	float d = x2 - x1;
+	if (d == 0.0f) return;
+
+	float id = 1.0f / d;
+	float au = (u2 - u1) * id;
+	float av = (v2 - v1) * id;
+	float aw = (w2 - w1) * id;
+
+	float znear = curTrilist->fog.near;
+	float zfar = curTrilist->fog.far;
+	float zscale = -1.0f / (znear - zfar);
+	__m256 znear_8 = _mm256_set1_ps(znear);
+	__m256 zscale_8 = _mm256_set1_ps(zscale);
+	__m256 fmax_8 = _mm256_set1_ps(1.0f);
+
+	int xb = (int)(x1);
+	int xe = (int)(x2 + 0.9999f);
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) {
+		float s = (float) (scissorX1 - xb);
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		xb = scissorX1;
+	}
+	if (xe <= xb) return;
+
+	__m256 r_8 = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+	__m256 u_8 = _mm256_fmadd_ps(_mm256_set1_ps(au), r_8, _mm256_set1_ps(u1));
+	__m256 v_8 = _mm256_fmadd_ps(_mm256_set1_ps(av), r_8, _mm256_set1_ps(v1));
+	__m256 w_8 = _mm256_fmadd_ps(_mm256_set1_ps(aw), r_8, _mm256_set1_ps(w1));
+
+	__m256 au_8 = _mm256_set1_ps(au * 8.0f);
+	__m256 av_8 = _mm256_set1_ps(av * 8.0f);
+	__m256 aw_8 = _mm256_set1_ps(aw * 8.0f);
+
+	LeColor * p = xb + ((int) y) * frame.tx + pixels;
+	int b = (xe - xb) >> 3;
+	int r = (xe - xb) & 0x7;
+
+	__m256  texScale_8 = _mm256_broadcastss_ps(texScale_4);
+	__m256i texMaskU_8 = _mm256_broadcastd_epi32(texMaskU_4);
+	__m256i texMaskV_8 = _mm256_broadcastd_epi32(texMaskV_4);
+#if LE_TEXTURE_TILING == 1
+	__m256i texTileMaskU_8 = _mm256_broadcastd_epi32(texTileMaskU_4);
+	__m256i texTileMaskV_8 = _mm256_broadcastd_epi32(texTileMaskV_4);
+#endif // LE_TEXTURE_TILING
+	__m256i color_8 = _mm256_broadcastsi128_si256(color_4);
+	__m256i zv = _mm256_setzero_si256();
+	__m256i sc = _mm256_set1_epi32(0x01000100);
+	__m256i fc = _mm256_unpacklo_epi8(_mm256_set1_epi32(*(int32_t *) &curTrilist->fog.color), zv);
+	__m256i m_8 = _mm256_cmpgt_epi32(_mm256_set1_epi32(r), _mm256_cvtps_epi32(r_8));
+
+	for (int x = 0; x <= b; x ++) {
+		if (x == b && r == 0) return;
+		__m256 z_8 = _mm256_rcp_ps(w_8);
+
+		__m256 mu_8, mv_8;
+		mu_8 = _mm256_mul_ps(u_8, z_8);
+		mv_8 = _mm256_mul_ps(v_8, z_8);
+		mv_8 = _mm256_mul_ps(mv_8, texScale_8);
+
+		__m256i mui_8, mvi_8;
+		mui_8 = _mm256_cvtps_epi32(mu_8);
+		mvi_8 = _mm256_cvtps_epi32(mv_8);
+#if LE_TEXTURE_TILING == 1
+		__m256i tui_8, tvi_8;
+		tui_8 = _mm256_and_si256(mui_8, texTileMaskU_8);
+		tvi_8 = _mm256_and_si256(_mm256_srl_epi32(mvi_8, texTileShiftU_4), texTileMaskV_8);
+		mui_8 = _mm256_and_si256(_mm256_sll_epi32(mui_8, texTileShiftV_4), texMaskU_8);
+		mvi_8 = _mm256_and_si256(mvi_8, texMaskV_8);
+		mui_8 = _mm256_add_epi32(_mm256_add_epi32(mui_8, tui_8), _mm256_add_epi32(mvi_8, tvi_8));
+#else
+		mui_8 = _mm256_and_si256(mui_8, texMaskU_8);
+		mvi_8 = _mm256_and_si256(mvi_8, texMaskV_8);
+		mui_8 = _mm256_add_epi32(mui_8, mvi_8);
+#endif // LE_TEXTURE_TILING
+
+		__m256 ff_8 = _mm256_mul_ps(_mm256_sub_ps(z_8, znear_8), zscale_8);
+		ff_8 = _mm256_max_ps(ff_8, _mm256_setzero_ps());
+		ff_8 = _mm256_min_ps(ff_8, fmax_8);
+		ff_8 = _mm256_mul_ps(_mm256_mul_ps(ff_8, ff_8), _mm256_set1_ps(256.0f));
+		__m256i fb = _mm256_cvttps_epi32(ff_8);
+		fb = _mm256_or_si256(fb, _mm256_slli_epi32(fb, 16));
+		__m256i fb1 = _mm256_unpacklo_epi32(fb, fb);
+		__m256i fb2 = _mm256_unpackhi_epi32(fb, fb);
+		__m256i nf1 = _mm256_sub_epi16(sc, fb1);
+		__m256i nf2 = _mm256_sub_epi16(sc, fb2);
+
+		__m256i tp, fp, t1, t2, f1, f2, n1, n2;
+		if (x == b) fp = _mm256_maskload_epi32((int *) p, m_8);
+		else fp = _mm256_loadu_si256((__m256i *) p);
+		f1 = _mm256_unpacklo_epi8(fp, zv);
+		f2 = _mm256_unpackhi_epi8(fp, zv);
+		tp = _mm256_i32gather_epi32((const int *) texDiffusePixels, mui_8, 4);
+		t1 = _mm256_unpacklo_epi8(tp, zv);
+		t2 = _mm256_unpackhi_epi8(tp, zv);
+
+		n1 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(t1, 0xFF), 0xFF);
+		n2 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(t2, 0xFF), 0xFF);
+		f1 = _mm256_mullo_epi16(f1, _mm256_sub_epi16(sc, n1));
+		f2 = _mm256_mullo_epi16(f2, _mm256_sub_epi16(sc, n2));
+		n1 = _mm256_srli_epi16(_mm256_mullo_epi16(fc, n1), 8);
+		n2 = _mm256_srli_epi16(_mm256_mullo_epi16(fc, n2), 8);
+
+		t1 = _mm256_mullo_epi16(t1, color_8);
+		t2 = _mm256_mullo_epi16(t2, color_8);
+		t1 = _mm256_srli_epi16(t1, 8);
+		t2 = _mm256_srli_epi16(t2, 8);
+		t1 = _mm256_add_epi16(_mm256_mullo_epi16(t1, nf1), _mm256_mullo_epi16(n1, fb1));
+		t2 = _mm256_add_epi16(_mm256_mullo_epi16(t2, nf2), _mm256_mullo_epi16(n2, fb2));
+		t1 = _mm256_adds_epu16(t1, f1);
+		t2 = _mm256_adds_epu16(t2, f2);
+		t1 = _mm256_srli_epi16(t1, 8);
+		t2 = _mm256_srli_epi16(t2, 8);
+		tp = _mm256_packus_epi16(t1, t2);
+
+		if (x == b) {
+			_mm256_maskstore_epi32((int *) p, m_8, tp);
+			return;
+		}
+		_mm256_storeu_si256((__m256i *) p, tp);
+		p += 8;
+
+		w_8 = _mm256_add_ps(w_8, aw_8);
+		u_8 = _mm256_add_ps(u_8, au_8);
+		v_8 = _mm256_add_ps(v_8, av_8);
+	}
+}
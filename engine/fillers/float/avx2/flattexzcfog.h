@@ -0,0 +1,154 @@
+/**
+	\file flattexzcfog.inc
+	\brief LightEngine 3D: Filler (avx2/float) - flat textured z-corrected scans with fog
+	\brief Intel x86 CPU (with AVX2) implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+inline void LeRasterizer::fillFlatTexZCFog(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	float d = x2 - x1;
+	if (d == 0.0f) return;
+
+	float au = (u2 - u1) / d;
+	float av = (v2 - v1) / d;
+	float aw = (w2 - w1) / d;
+
+	float znear = curTrilist->fog.near;
+	float zfar = curTrilist->fog.far;
+	float zscale = -1.0f / (znear - zfar);
+	__m256 znear_8 = _mm256_set1_ps(znear);
+	__m256 zscale_8 = _mm256_set1_ps(zscale);
+	__m256 fmax_8 = _mm256_set1_ps(1.0f);
+
+	int xb = (int)(x1);
+	int xe = (int)(x2 + 0.9999f);
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) {
+		float s = (float) (scissorX1 - xb);
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		xb = scissorX1;
+	}
+	if (xe <= xb) return;
+
+	__m256 r_8 = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+
+	LeColor * p = xb + ((int) y) * frame.tx + pixels;
+	int b = (xe - xb) >> 3;
+	int r = (xe - xb) & 0x7;
+
+// Texel indexes as texelIndex() (truncated coordinates)
+	__m256i texMaskU_8 = _mm256_set1_epi32(texMaskU);
+	__m256i texMaskV_8 = _mm256_set1_epi32(texMaskV);
+	__m128i texSizeU_4 = _mm_cvtsi32_si128(texSizeU);
+#if LE_TEXTURE_TILING == 1
+	__m256i texTileMaskU_8 = _mm256_set1_epi32(texTileMaskU);
+	__m256i texTileMaskV_8 = _mm256_set1_epi32(texTileMaskV);
+	__m128i texTileU_4 = _mm_cvtsi32_si128(texTileU);
+	__m128i texTileV_4 = _mm_cvtsi32_si128(texTileV);
+#endif // LE_TEXTURE_TILING
+	__m256i color_8 = _mm256_broadcastsi128_si256(color_4);
+	__m256i zv = _mm256_setzero_si256();
+	__m256i fc = _mm256_unpacklo_epi8(_mm256_set1_epi32(*(int32_t *) &curTrilist->fog.color), zv);
+	__m256d one_4 = _mm256_set1_pd(1.0);
+	__m256i m_8 = _mm256_cmpgt_epi32(_mm256_set1_epi32(r), _mm256_cvtps_epi32(r_8));
+
+	for (int x = 0; x <= b; x ++) {
+		if (x == b && r == 0) return;
+	// Interpolants stepped pixel per pixel (as the reference filler)
+		float ub[8], vb[8], wb[8];
+		for (int i = 0; i < 8; i++) {
+			ub[i] = u1;
+			vb[i] = v1;
+			wb[i] = w1;
+			u1 += au;
+			v1 += av;
+			w1 += aw;
+		}
+		__m256 u_8 = _mm256_loadu_ps(ub);
+		__m256 v_8 = _mm256_loadu_ps(vb);
+
+	// Correctly rounded reciprocals (fast math turns single precision divides into approximations)
+		__m128 zl_4 = _mm256_cvtpd_ps(_mm256_div_pd(one_4, _mm256_cvtps_pd(_mm_loadu_ps(wb))));
+		__m128 zh_4 = _mm256_cvtpd_ps(_mm256_div_pd(one_4, _mm256_cvtps_pd(_mm_loadu_ps(wb + 4))));
+		__m256 z_8 = _mm256_insertf128_ps(_mm256_castps128_ps256(zl_4), zh_4, 1);
+
+		__m256i tu_8, tv_8, mui_8;
+		tu_8 = _mm256_cvttps_epi32(_mm256_mul_ps(u_8, z_8));
+		tv_8 = _mm256_cvttps_epi32(_mm256_mul_ps(v_8, z_8));
+		tu_8 = _mm256_and_si256(tu_8, texMaskU_8);
+		tv_8 = _mm256_and_si256(tv_8, texMaskV_8);
+#if LE_TEXTURE_TILING == 1
+		__m256i lu_8, lv_8;
+		lu_8 = _mm256_and_si256(tu_8, texTileMaskU_8);
+		lv_8 = _mm256_and_si256(tv_8, texTileMaskV_8);
+		mui_8 = _mm256_add_epi32(lu_8, _mm256_sll_epi32(_mm256_sub_epi32(tu_8, lu_8), texTileV_4));
+		mui_8 = _mm256_add_epi32(mui_8, _mm256_sll_epi32(lv_8, texTileU_4));
+		mui_8 = _mm256_add_epi32(mui_8, _mm256_sll_epi32(_mm256_sub_epi32(tv_8, lv_8), texSizeU_4));
+#else
+		mui_8 = _mm256_add_epi32(tu_8, _mm256_sll_epi32(tv_8, texSizeU_4));
+#endif // LE_TEXTURE_TILING
+
+	// Fog blend factor (0 - 256)
+		__m256 ff_8 = _mm256_mul_ps(_mm256_sub_ps(z_8, znear_8), zscale_8);
+		ff_8 = _mm256_max_ps(ff_8, _mm256_setzero_ps());
+		ff_8 = _mm256_min_ps(ff_8, fmax_8);
+		ff_8 = _mm256_mul_ps(_mm256_mul_ps(ff_8, ff_8), _mm256_set1_ps(256.0f));
+		__m256i fb = _mm256_cvttps_epi32(ff_8);
+		fb = _mm256_or_si256(fb, _mm256_slli_epi32(fb, 16));
+		__m256i fb1 = _mm256_unpacklo_epi32(fb, fb);
+		__m256i fb2 = _mm256_unpackhi_epi32(fb, fb);
+
+		__m256i tp, t1, t2, d1, d2;
+		tp = _mm256_i32gather_epi32((const int *) texDiffusePixels, mui_8, 4);
+		t1 = _mm256_unpacklo_epi8(tp, zv);
+		t2 = _mm256_unpackhi_epi8(tp, zv);
+		t1 = _mm256_mullo_epi16(t1, color_8);
+		t2 = _mm256_mullo_epi16(t2, color_8);
+		t1 = _mm256_srli_epi16(t1, 8);
+		t2 = _mm256_srli_epi16(t2, 8);
+
+	// Blend as t + (((fc - t) * fb) >> 8) (signed 24 bit products)
+		d1 = _mm256_sub_epi16(fc, t1);
+		d2 = _mm256_sub_epi16(fc, t2);
+		d1 = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(d1, fb1), 8), _mm256_slli_epi16(_mm256_mulhi_epi16(d1, fb1), 8));
+		d2 = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(d2, fb2), 8), _mm256_slli_epi16(_mm256_mulhi_epi16(d2, fb2), 8));
+		t1 = _mm256_add_epi16(t1, d1);
+		t2 = _mm256_add_epi16(t2, d2);
+		tp = _mm256_packus_epi16(t1, t2);
+
+		if (x == b) {
+			_mm256_maskstore_epi32((int *) p, m_8, tp);
+			return;
+		}
+		_mm256_storeu_si256((__m256i *) p, tp);
+		p += 8;
+	}
+}
@@ -0,0 +1,192 @@
+/**
+	\file halfspacetexzc.h
+	\brief LightEngine 3D: Filler (avx2/float) - half-space textured z-corrected triangles
+	\brief Intel x86 CPU (with AVX2) implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+inline void LeRasterizer::fillHalfSpaceTexZC()
+{
+// Orient the triangle (edge functions positive inside)
+	int vi[3] = {0, 1, 2};
+	int ix[3], iy[3];
+	for (int i = 0; i < 3; i++) {
+		ix[i] = (int) xs[i];
+		iy[i] = (int) ys[i];
+	}
+
+	int64_t area = (int64_t) (ix[1] - ix[0]) * (iy[2] - iy[0]) - (int64_t) (ix[2] - ix[0]) * (iy[1] - iy[0]);
+	if (area == 0) return;
+	if (area < 0) {
+		int t = ix[1]; ix[1] = ix[2]; ix[2] = t;
+		t = iy[1]; iy[1] = iy[2]; iy[2] = t;
+		vi[1] = 2; vi[2] = 1;
+		area = -area;
+	}
+
+// Bounding box scissored against the frame (or tile)
+	int bx1 = cmmax(cmmin(cmmin(ix[0], ix[1]), ix[2]), scissorX1);
+	int by1 = cmmax(cmmin(cmmin(iy[0], iy[1]), iy[2]), scissorY1);
+	int bx2 = cmmin(cmmax(cmmax(ix[0], ix[1]), ix[2]), scissorX2);
+	int by2 = cmmin(cmmax(cmmax(iy[0], iy[1]), iy[2]), scissorY2);
+	if (bx1 >= bx2 || by1 >= by2) return;
+
+// Edge functions (doubled coordinates, sampled at pixel centers, top-left rule)
+	int ex[3], ey[3];
+	int64_t eo[3];
+	for (int k = 0; k < 3; k++) {
+		int a = k;
+		int b = k == 2 ? 0 : k + 1;
+		int dx = ix[b] - ix[a];
+		int dy = iy[b] - iy[a];
+		int bias = (dy < 0 || (dy == 0 && dx > 0)) ? 0 : -1;
+		ex[k] = -2 * dy;
+		ey[k] = 2 * dx;
+		eo[k] = (int64_t) dx * (2 * (by1 - iy[a]) + 1) - (int64_t) dy * (2 * (bx1 - ix[a]) + 1) + bias;
+	}
+
+// Attribute planes (same perspective-correct interpolants as the scan fillers)
+	float fa = 1.0f / (float) area;
+	float dx1 = (float) (ix[1] - ix[0]);
+	float dy1 = (float) (iy[1] - iy[0]);
+	float dx2 = (float) (ix[2] - ix[0]);
+	float dy2 = (float) (iy[2] - iy[0]);
+
+	float w0 = ws[vi[0]], dw1 = ws[vi[1]] - w0, dw2 = ws[vi[2]] - w0;
+	float u0 = us[vi[0]], du1 = us[vi[1]] - u0, du2 = us[vi[2]] - u0;
+	float v0 = vs[vi[0]], dv1 = vs[vi[1]] - v0, dv2 = vs[vi[2]] - v0;
+
+	float awx = (dw1 * dy2 - dw2 * dy1) * fa;
+	float awy = (dw2 * dx1 - dw1 * dx2) * fa;
+	float aux = (du1 * dy2 - du2 * dy1) * fa;
+	float auy = (du2 * dx1 - du1 * dx2) * fa;
+	float avx = (dv1 * dy2 - dv2 * dy1) * fa;
+	float avy = (dv2 * dx1 - dv1 * dx2) * fa;
+
+	__m256 r_8 = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+	__m256 aw_8 = _mm256_mul_ps(_mm256_set1_ps(awx), r_8);
+	__m256 au_8 = _mm256_mul_ps(_mm256_set1_ps(aux), r_8);
+	__m256 av_8 = _mm256_mul_ps(_mm256_set1_ps(avx), r_8);
+
+	__m256i lane_8 = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+	__m256i ex_8[3];
+	for (int k = 0; k < 3; k++)
+		ex_8[k] = _mm256_mullo_epi32(_mm256_set1_epi32(ex[k]), lane_8);
+	__m256i none_8 = _mm256_set1_epi32(-1);
+
+	__m256  texScale_8 = _mm256_broadcastss_ps(texScale_4);
+	__m256i texMaskU_8 = _mm256_broadcastd_epi32(texMaskU_4);
+	__m256i texMaskV_8 = _mm256_broadcastd_epi32(texMaskV_4);
+#if LE_TEXTURE_TILING == 1
+	__m256i texTileMaskU_8 = _mm256_broadcastd_epi32(texTileMaskU_4);
+	__m256i texTileMaskV_8 = _mm256_broadcastd_epi32(texTileMaskV_4);
+#endif // LE_TEXTURE_TILING
+	__m256i color_8 = _mm256_broadcastsi128_si256(color_4);
+	__m256i zv = _mm256_setzero_si256();
+
+// Walk the 8x2 pixel blocks (one row of a block per vector)
+	for (int by = by1; by < by2; by += 2) {
+		int ye = cmmin(by + 2, by2);
+		for (int bx = bx1; bx < bx2; bx += 8) {
+			int ebk[3];
+			bool accept = bx + 8 <= bx2 && ye == by + 2;
+			bool reject = false;
+			for (int k = 0; k < 3; k++) {
+				int64_t e = eo[k] + (int64_t) ex[k] * (bx - bx1) + (int64_t) ey[k] * (by - by1);
+				int64_t emax = e + cmmax(0, 7 * ex[k]) + cmmax(0, ey[k]);
+				int64_t emin = e + cmmin(0, 7 * ex[k]) + cmmin(0, ey[k]);
+				if (emax < 0) {reject = true; break;}
+				if (emin < 0) accept = false;
+				e = cmmin(e, (int64_t) 1 << 30);
+				e = cmmax(e, -((int64_t) 1 << 30));
+				ebk[k] = (int) e;
+			}
+			if (reject) continue;
+
+		// Columns inside the bounding box
+			__m256i col_8 = _mm256_cmpgt_epi32(_mm256_set1_epi32(bx2 - bx), lane_8);
+
+			for (int y = by; y < ye; y++) {
+				int j = y - by;
+				__m256i mask_8 = none_8;
+				if (!accept) {
+					__m256i e0_8 = _mm256_add_epi32(_mm256_set1_epi32(ebk[0] + ey[0] * j), ex_8[0]);
+					__m256i e1_8 = _mm256_add_epi32(_mm256_set1_epi32(ebk[1] + ey[1] * j), ex_8[1]);
+					__m256i e2_8 = _mm256_add_epi32(_mm256_set1_epi32(ebk[2] + ey[2] * j), ex_8[2]);
+					mask_8 = _mm256_and_si256(col_8, _mm256_cmpgt_epi32(e0_8, none_8));
+					mask_8 = _mm256_and_si256(mask_8, _mm256_cmpgt_epi32(e1_8, none_8));
+					mask_8 = _mm256_and_si256(mask_8, _mm256_cmpgt_epi32(e2_8, none_8));
+					if (_mm256_testz_si256(mask_8, mask_8)) continue;
+				}
+
+				float xo = (float) (bx - ix[0]);
+				float yo = (float) (y - iy[0]);
+				__m256 w_8 = _mm256_add_ps(_mm256_set1_ps(w0 + awx * xo + awy * yo), aw_8);
+				__m256 u_8 = _mm256_add_ps(_mm256_set1_ps(u0 + aux * xo + auy * yo), au_8);
+				__m256 v_8 = _mm256_add_ps(_mm256_set1_ps(v0 + avx * xo + avy * yo), av_8);
+				__m256 z_8 = _mm256_rcp_ps(w_8);
+
+				__m256 mu_8, mv_8;
+				mu_8 = _mm256_mul_ps(u_8, z_8);
+				mv_8 = _mm256_mul_ps(v_8, z_8);
+				mv_8 = _mm256_mul_ps(mv_8, texScale_8);
+
+				__m256i mui_8, mvi_8;
+				mui_8 = _mm256_cvtps_epi32(mu_8);
+				mvi_8 = _mm256_cvtps_epi32(mv_8);
+#if LE_TEXTURE_TILING == 1
+				__m256i tui_8, tvi_8;
+				tui_8 = _mm256_and_si256(mui_8, texTileMaskU_8);
+				tvi_8 = _mm256_and_si256(_mm256_srl_epi32(mvi_8, texTileShiftU_4), texTileMaskV_8);
+				mui_8 = _mm256_and_si256(_mm256_sll_epi32(mui_8, texTileShiftV_4), texMaskU_8);
+				mvi_8 = _mm256_and_si256(mvi_8, texMaskV_8);
+				mui_8 = _mm256_add_epi32(_mm256_add_epi32(mui_8, tui_8), _mm256_add_epi32(mvi_8, tvi_8));
+#else
+				mui_8 = _mm256_and_si256(mui_8, texMaskU_8);
+				mvi_8 = _mm256_and_si256(mvi_8, texMaskV_8);
+				mui_8 = _mm256_add_epi32(mui_8, mvi_8);
+#endif // LE_TEXTURE_TILING
+
+				__m256i tp, t1, t2;
+				tp = _mm256_mask_i32gather_epi32(zv, (const int *) texDiffusePixels, mui_8, mask_8, 4);
+				t1 = _mm256_unpacklo_epi8(tp, zv);
+				t2 = _mm256_unpackhi_epi8(tp, zv);
+				t1 = _mm256_mullo_epi16(t1, color_8);
+				t2 = _mm256_mullo_epi16(t2, color_8);
+				t1 = _mm256_srli_epi16(t1, 8);
+				t2 = _mm256_srli_epi16(t2, 8);
+				tp = _mm256_packus_epi16(t1, t2);
+
+			// Store the covered pixels (never touch the pixels outside)
+				LeColor * p = bx + y * frame.tx + pixels;
+				if (accept) _mm256_storeu_si256((__m256i *) p, tp);
+				else _mm256_maskstore_epi32((int *) p, mask_8, tp);
+			}
+		}
+	}
+}
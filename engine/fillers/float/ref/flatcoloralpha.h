@@ -0,0 +1,61 @@
+/**
+	\file flatcoloralpha.h
+	\brief LightEngine 3D: Filler (ref/float) - flat untextured alpha blended scans
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+inline void LeRasterizer::fillFlatColorAlpha(int y, float x1, float x2, float w1, float w2)
+{
+	uint8_t * sc = (uint8_t *) &curTriangle->solidColor;
+
+	float d = x2 - x1;
+	if (d == 0.0f) return;
+
+	int xb = (int)(x1);
+	int xe = (int)(x2 + 0.9999f);
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) xb = scissorX1;
+
+// Solid color alpha is not pre-multiplied
+	int a = sc[3];
+	int r = sc[0] * a;
+	int g = sc[1] * a;
+	int b = sc[2] * a;
+	a = 256 - a;
+
+	uint8_t * p = (uint8_t *) (xb + y * frame.tx + pixels);
+
+	for (int x = xb; x < xe; x++) {
+		p[0] = (p[0] * a + r) >> 8;
+		p[1] = (p[1] * a + g) >> 8;
+		p[2] = (p[2] * a + b) >> 8;
+		p += 4;
+	}
+}
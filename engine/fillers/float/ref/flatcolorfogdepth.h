@@ -0,0 +1,79 @@
+/**
+	\file flatcolorfogdepth.h
+	\brief LightEngine 3D: Filler (ref/float) - flat untextured fogged scans (depth tested & written)
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+inline void LeRasterizer::fillFlatColorFogDepth(int y, float x1, float x2, float w1, float w2)
+{
+	uint8_t * sc = (uint8_t *) &curTriangle->solidColor;
+	uint8_t * fc = (uint8_t *) &curTrilist->fog.color;
+
+	float d = x2 - x1;
+	if (d == 0.0f) return;
+
+	float aw = (w2 - w1) / d;
+
+	float znear = curTrilist->fog.near;
+	float zfar = curTrilist->fog.far;
+	float zscale = -1.0f / (znear - zfar);
+
+	int xb = (int)(x1);
+	int xe = (int)(x2 + 0.9999f);
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) {
+		float s = (float) (scissorX1 - xb);
+		w1 += aw * s;
+		xb = scissorX1;
+	}
+
+	uint8_t * p = (uint8_t *)(xb + y * frame.tx + pixels);
+	float * zb = xb + y * frame.tx + depth;
+
+	for (int x = xb; x < xe; x++) {
+		if (w1 < *zb) {
+			*zb = w1;
+			float z = 1.0f / w1;
+			float ff = (z - znear) * zscale;
+			ff = cmmax(0.0f, ff);
+			ff = cmmin(1.0f, ff);
+			ff = 256.0f * ff * ff;
+			int fb = (int) ff;
+
+			p[0] = sc[0] + (((fc[0] - sc[0]) * fb) >> 8);
+			p[1] = sc[1] + (((fc[1] - sc[1]) * fb) >> 8);
+			p[2] = sc[2] + (((fc[2] - sc[2]) * fb) >> 8);
+		}
+		p += 4;
+		zb++;
+
+		w1 += aw;
+	}
+}
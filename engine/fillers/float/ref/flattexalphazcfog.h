@@ -48,7 +48,14 @@ inline void LeRasterizer::fillFlatTexAlphaZCFog(int y, float x1, float x2, float
 
 	int xb = (int)(x1);
 	int xe = (int)(x2 + 0.9999f);
-	if (xe > frame.tx) xe = frame.tx;
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) {
+		float s = (float) (scissorX1 - xb);
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		xb = scissorX1;
+	}
 
 	uint8_t * p = (uint8_t *)(xb + ((int)y) * frame.tx + pixels);
 
@@ -56,7 +63,7 @@ inline void LeRasterizer::fillFlatTexAlphaZCFog(int y, float x1, float x2, float
 		float z = 1.0f / w1;
 		uint32_t tu = ((int32_t)(u1 * z)) & texMaskU;
 		uint32_t tv = ((int32_t)(v1 * z)) & texMaskV;
-		uint8_t * t = (uint8_t *)&texDiffusePixels[tu + (tv << texSizeU)];
+		uint8_t * t = (uint8_t *)&texDiffusePixels[texelIndex(tu, tv)];
 
 		float ff = (z - znear) * zscale;
 		ff = cmmax(0.0f, ff);
@@ -43,7 +43,14 @@ inline void LeRasterizer::fillFlatTexZC(int y, float x1, float x2, float w1, flo
 
 	int xb = (int) (x1);
 	int xe = (int) (x2 + 0.9999f);
-	if (xe > frame.tx) xe = frame.tx;
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) {
+		float s = (float) (scissorX1 - xb);
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		xb = scissorX1;
+	}
 
 	uint8_t * p = (uint8_t *) (xb + ((int) y) * frame.tx + pixels);
 	
@@ -51,7 +58,7 @@ inline void LeRasterizer::fillFlatTexZC(int y, float x1, float x2, float w1, flo
 		float z = 1.0f / w1;
 		uint32_t tu = ((int32_t) (u1 * z)) & texMaskU;
 		uint32_t tv = ((int32_t) (v1 * z)) & texMaskV;
-		uint8_t * t = (uint8_t *) &texDiffusePixels[tu + (tv << texSizeU)];
+		uint8_t * t = (uint8_t *) &texDiffusePixels[texelIndex(tu, tv)];
 
 		p[0] = (t[0] * c[0]) >> 8;
 		p[1] = (t[1] * c[1]) >> 8;
@@ -0,0 +1,77 @@
+/**
+	\file flattexzcdepth.inc
+	\brief LightEngine 3D: Filler (ref/float) - flat textured z-corrected scans (depth tested & written)
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+inline void LeRasterizer::fillFlatTexZCDepth(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	uint8_t * c = (uint8_t *) &curTriangle->solidColor;
+
+	float d = x2 - x1;
+	if (d == 0.0f) return;
+
+	float au = (u2 - u1) / d;
+	float av = (v2 - v1) / d;
+	float aw = (w2 - w1) / d;
+
+	int xb = (int) (x1);
+	int xe = (int) (x2 + 0.9999f);
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) {
+		float s = (float) (scissorX1 - xb);
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		xb = scissorX1;
+	}
+
+	uint8_t * p = (uint8_t *) (xb + ((int) y) * frame.tx + pixels);
+	float * zb = xb + ((int) y) * frame.tx + depth;
+	
+	for (int x = xb; x < xe; x++) {
+		if (w1 < *zb) {
+			*zb = w1;
+			float z = 1.0f / w1;
+			uint32_t tu = ((int32_t) (u1 * z)) & texMaskU;
+			uint32_t tv = ((int32_t) (v1 * z)) & texMaskV;
+			uint8_t * t = (uint8_t *) &texDiffusePixels[texelIndex(tu, tv)];
+
+			p[0] = (t[0] * c[0]) >> 8;
+			p[1] = (t[1] * c[1]) >> 8;
+			p[2] = (t[2] * c[2]) >> 8;
+		}
+		p += 4;
+		zb++;
+
+		u1 += au;
+		v1 += av;
+		w1 += aw;
+	}
+}
@@ -0,0 +1,143 @@
+/**
+	\file halfspacetexzc.h
+	\brief LightEngine 3D: Filler (ref/float) - half-space textured z-corrected triangles
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+inline void LeRasterizer::fillHalfSpaceTexZC()
+{
+	uint8_t * c = (uint8_t *) &curTriangle->solidColor;
+
+// Orient the triangle (edge functions positive inside)
+	int vi[3] = {0, 1, 2};
+	int ix[3], iy[3];
+	for (int i = 0; i < 3; i++) {
+		ix[i] = (int) xs[i];
+		iy[i] = (int) ys[i];
+	}
+
+	int64_t area = (int64_t) (ix[1] - ix[0]) * (iy[2] - iy[0]) - (int64_t) (ix[2] - ix[0]) * (iy[1] - iy[0]);
+	if (area == 0) return;
+	if (area < 0) {
+		int t = ix[1]; ix[1] = ix[2]; ix[2] = t;
+		t = iy[1]; iy[1] = iy[2]; iy[2] = t;
+		vi[1] = 2; vi[2] = 1;
+		area = -area;
+	}
+
+// Bounding box scissored against the frame (or tile)
+	int bx1 = cmmax(cmmin(cmmin(ix[0], ix[1]), ix[2]), scissorX1);
+	int by1 = cmmax(cmmin(cmmin(iy[0], iy[1]), iy[2]), scissorY1);
+	int bx2 = cmmin(cmmax(cmmax(ix[0], ix[1]), ix[2]), scissorX2);
+	int by2 = cmmin(cmmax(cmmax(iy[0], iy[1]), iy[2]), scissorY2);
+	if (bx1 >= bx2 || by1 >= by2) return;
+
+// Edge functions (doubled coordinates, sampled at pixel centers, top-left rule)
+	int ex[3], ey[3];
+	int64_t eo[3];
+	for (int k = 0; k < 3; k++) {
+		int a = k;
+		int b = k == 2 ? 0 : k + 1;
+		int dx = ix[b] - ix[a];
+		int dy = iy[b] - iy[a];
+		int bias = (dy < 0 || (dy == 0 && dx > 0)) ? 0 : -1;
+		ex[k] = -2 * dy;
+		ey[k] = 2 * dx;
+		eo[k] = (int64_t) dx * (2 * (by1 - iy[a]) + 1) - (int64_t) dy * (2 * (bx1 - ix[a]) + 1) + bias;
+	}
+
+// Attribute planes (same perspective-correct interpolants as the scan fillers)
+	float fa = 1.0f / (float) area;
+	float dx1 = (float) (ix[1] - ix[0]);
+	float dy1 = (float) (iy[1] - iy[0]);
+	float dx2 = (float) (ix[2] - ix[0]);
+	float dy2 = (float) (iy[2] - iy[0]);
+
+	float w0 = ws[vi[0]], dw1 = ws[vi[1]] - w0, dw2 = ws[vi[2]] - w0;
+	float u0 = us[vi[0]], du1 = us[vi[1]] - u0, du2 = us[vi[2]] - u0;
+	float v0 = vs[vi[0]], dv1 = vs[vi[1]] - v0, dv2 = vs[vi[2]] - v0;
+
+	float awx = (dw1 * dy2 - dw2 * dy1) * fa;
+	float awy = (dw2 * dx1 - dw1 * dx2) * fa;
+	float aux = (du1 * dy2 - du2 * dy1) * fa;
+	float auy = (du2 * dx1 - du1 * dx2) * fa;
+	float avx = (dv1 * dy2 - dv2 * dy1) * fa;
+	float avy = (dv2 * dx1 - dv1 * dx2) * fa;
+
+// Walk the 4x4 pixel blocks
+	for (int by = by1; by < by2; by += 4) {
+		int ye = cmmin(by + 4, by2);
+		for (int bx = bx1; bx < bx2; bx += 4) {
+			int xe = cmmin(bx + 4, bx2);
+			int64_t ebk[3];
+			bool accept = true;
+			bool reject = false;
+			for (int k = 0; k < 3; k++) {
+				ebk[k] = eo[k] + (int64_t) ex[k] * (bx - bx1) + (int64_t) ey[k] * (by - by1);
+				int64_t emax = ebk[k] + cmmax(0, 3 * ex[k]) + cmmax(0, 3 * ey[k]);
+				int64_t emin = ebk[k] + cmmin(0, 3 * ex[k]) + cmmin(0, 3 * ey[k]);
+				if (emax < 0) {reject = true; break;}
+				if (emin < 0) accept = false;
+			}
+			if (reject) continue;
+
+			for (int y = by; y < ye; y++) {
+				int j = y - by;
+				float xo = (float) (bx - ix[0]);
+				float yo = (float) (y - iy[0]);
+				float w = w0 + awx * xo + awy * yo;
+				float u = u0 + aux * xo + auy * yo;
+				float v = v0 + avx * xo + avy * yo;
+
+				uint8_t * p = (uint8_t *) (bx + y * frame.tx + pixels);
+				for (int x = bx; x < xe; x++) {
+					int i = x - bx;
+					if (accept ||
+						(ebk[0] + ex[0] * i + ey[0] * j >= 0 &&
+						 ebk[1] + ex[1] * i + ey[1] * j >= 0 &&
+						 ebk[2] + ex[2] * i + ey[2] * j >= 0)) {
+						float z = 1.0f / w;
+						uint32_t tu = ((int32_t) (u * z)) & texMaskU;
+						uint32_t tv = ((int32_t) (v * z)) & texMaskV;
+						uint8_t * t = (uint8_t *) &texDiffusePixels[texelIndex(tu, tv)];
+
+						p[0] = (t[0] * c[0]) >> 8;
+						p[1] = (t[1] * c[1]) >> 8;
+						p[2] = (t[2] * c[2]) >> 8;
+					}
+					p += 4;
+
+					u += aux;
+					v += avx;
+					w += awx;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,60 @@
+/**
+	\file flatcolor.h
+	\brief LightEngine 3D: Filler (sse/float) - flat untextured scans
+	\brief Intel x86 CPU (with MMX-SSE-SSE2) implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+inline void LeRasterizer::fillFlatColor(int y, float x1, float x2, float w1, float w2)
+{
+	uint32_t c = *((uint32_t *) &curTriangle->solidColor);
+
+	float d = x2 - x1;
+	if (d == 0.0f) return;
+
+	int xb = (int)(x1);
+	int xe = (int)(x2 + 0.9999f);
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) xb = scissorX1;
+	if (xe <= xb) return;
+
+	uint32_t * p = (uint32_t *) (xb + y * frame.tx + pixels);
+	uint32_t * e = (uint32_t *) (xe + y * frame.tx + pixels);
+
+// Align on 16 bytes, then fill with aligned stores
+	while (p < e && ((uintptr_t) p & 0xF))
+		*p++ = c;
+
+	__m128i c_4 = _mm_set1_epi32(c);
+	for (; p + 4 <= e; p += 4)
+		_mm_store_si128((__m128i *) p, c_4);
+
+	while (p < e)
+		*p++ = c;
+}
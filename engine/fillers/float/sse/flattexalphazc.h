@@ -40,6 +40,18 @@ inline void LeRasterizer::fillFlatTexAlphaZC(int y, float x1, float x2, float w1
 	float av = (v2 - v1) * id;
 	float aw = (w2 - w1) * id;
 
+	int xb = (int)(x1);
+	int xe = (int)(x2 + 0.9999f);
+	if (xe > scissorX2) xe = scissorX2;
+	if (xb < scissorX1) {
+		float s = (float) (scissorX1 - xb);
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		xb = scissorX1;
+	}
+	if (xe <= xb) return;
+
 	__m128 u_4 = _mm_set_ps(u1 + 3.0f * au, u1 + 2.0f * au, u1 + au, u1);
 	__m128 v_4 = _mm_set_ps(v1 + 3.0f * av, v1 + 2.0f * av, v1 + av, v1);
 	__m128 w_4 = _mm_set_ps(w1 + 3.0f * aw, w1 + 2.0f * aw, w1 + aw, w1);
@@ -47,10 +59,6 @@ inline void LeRasterizer::fillFlatTexAlphaZC(int y, float x1, float x2, float w1
 	__m128 au_4 = _mm_set1_ps(au * 4.0f);
 	__m128 av_4 = _mm_set1_ps(av * 4.0f);
 	__m128 aw_4 = _mm_set1_ps(aw * 4.0f);
-	
-	int xb = (int)(x1);
-	int xe = (int)(x2 + 0.9999f);
-	if (xe > frame.tx) xe = frame.tx;
 
 	LeColor * p = xb + ((int) y) * frame.tx + pixels;
 	int b = (xe - xb) >> 2;
@@ -68,9 +76,18 @@ inline void LeRasterizer::fillFlatTexAlphaZC(int y, float x1, float x2, float w1
 		__m128i mui_4, mvi_4;
 		mui_4 = _mm_cvtps_epi32(mu_4);
 		mvi_4 = _mm_cvtps_epi32(mv_4);
+#if LE_TEXTURE_TILING == 1
+		__m128i tui_4, tvi_4;
+		tui_4 = _mm_and_si128(mui_4, texTileMaskU_4);
+		tvi_4 = _mm_and_si128(_mm_srl_epi32(mvi_4, texTileShiftU_4), texTileMaskV_4);
+		mui_4 = _mm_and_si128(_mm_sll_epi32(mui_4, texTileShiftV_4), texMaskU_4);
+		mvi_4 = _mm_and_si128(mvi_4, texMaskV_4);
+		mui_4 = _mm_add_epi32(_mm_add_epi32(mui_4, tui_4), _mm_add_epi32(mvi_4, tvi_4));
+#else
 		mui_4 = _mm_and_si128(mui_4, texMaskU_4);
 		mvi_4 = _mm_and_si128(mvi_4, texMaskV_4);
 		mui_4 = _mm_add_epi32(mui_4, mvi_4);
+#endif // LE_TEXTURE_TILING
 
 		__m128i zv = _mm_set1_epi32(0);
 		__m128i tp, tq, fp, t1, t2;
@@ -130,9 +147,18 @@ inline void LeRasterizer::fillFlatTexAlphaZC(int y, float x1, float x2, float w1
 	__m128i mui_4, mvi_4;
 	mui_4 = _mm_cvtps_epi32(mu_4);
 	mvi_4 = _mm_cvtps_epi32(mv_4);
+#if LE_TEXTURE_TILING == 1
+	__m128i tui_4, tvi_4;
+	tui_4 = _mm_and_si128(mui_4, texTileMaskU_4);
+	tvi_4 = _mm_and_si128(_mm_srl_epi32(mvi_4, texTileShiftU_4), texTileMaskV_4);
+	mui_4 = _mm_and_si128(_mm_sll_epi32(mui_4, texTileShiftV_4), texMaskU_4);
+	mvi_4 = _mm_and_si128(mvi_4, texMaskV_4);
+	mui_4 = _mm_add_epi32(_mm_add_epi32(mui_4, tui_4), _mm_add_epi32(mvi_4, tvi_4));
+#else
 	mui_4 = _mm_and_si128( mui_4, texMaskU_4);
 	mvi_4 = _mm_and_si128( mvi_4, texMaskV_4);
 	mui_4 = _mm_add_epi32(mui_4, mvi_4);
+#endif // LE_TEXTURE_TILING
 
 	__m128i zv = _mm_set1_epi32(0);
 	__m128i tp, fp;
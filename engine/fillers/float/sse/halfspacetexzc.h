@@ -0,0 +1,198 @@
+/**
+	\file halfspacetexzc.h
+	\brief LightEngine 3D: Filler (sse/float) - half-space textured z-corrected triangles
+	\brief Intel x86 CPU (with MMX-SSE-SSE2) implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+inline void LeRasterizer::fillHalfSpaceTexZC()
+{
+// Orient the triangle (edge functions positive inside)
+	int vi[3] = {0, 1, 2};
+	int ix[3], iy[3];
+	for (int i = 0; i < 3; i++) {
+		ix[i] = (int) xs[i];
+		iy[i] = (int) ys[i];
+	}
+
+	int64_t area = (int64_t) (ix[1] - ix[0]) * (iy[2] - iy[0]) - (int64_t) (ix[2] - ix[0]) * (iy[1] - iy[0]);
+	if (area == 0) return;
+	if (area < 0) {
+		int t = ix[1]; ix[1] = ix[2]; ix[2] = t;
+		t = iy[1]; iy[1] = iy[2]; iy[2] = t;
+		vi[1] = 2; vi[2] = 1;
+		area = -area;
+	}
+
+// Bounding box scissored against the frame (or tile)
+	int bx1 = cmmax(cmmin(cmmin(ix[0], ix[1]), ix[2]), scissorX1);
+	int by1 = cmmax(cmmin(cmmin(iy[0], iy[1]), iy[2]), scissorY1);
+	int bx2 = cmmin(cmmax(cmmax(ix[0], ix[1]), ix[2]), scissorX2);
+	int by2 = cmmin(cmmax(cmmax(iy[0], iy[1]), iy[2]), scissorY2);
+	if (bx1 >= bx2 || by1 >= by2) return;
+
+// Edge functions (doubled coordinates, sampled at pixel centers, top-left rule)
+	int ex[3], ey[3];
+	int64_t eo[3];
+	for (int k = 0; k < 3; k++) {
+		int a = k;
+		int b = k == 2 ? 0 : k + 1;
+		int dx = ix[b] - ix[a];
+		int dy = iy[b] - iy[a];
+		int bias = (dy < 0 || (dy == 0 && dx > 0)) ? 0 : -1;
+		ex[k] = -2 * dy;
+		ey[k] = 2 * dx;
+		eo[k] = (int64_t) dx * (2 * (by1 - iy[a]) + 1) - (int64_t) dy * (2 * (bx1 - ix[a]) + 1) + bias;
+	}
+
+// Attribute planes (same perspective-correct interpolants as the scan fillers)
+	float fa = 1.0f / (float) area;
+	float dx1 = (float) (ix[1] - ix[0]);
+	float dy1 = (float) (iy[1] - iy[0]);
+	float dx2 = (float) (ix[2] - ix[0]);
+	float dy2 = (float) (iy[2] - iy[0]);
+
+	float w0 = ws[vi[0]], dw1 = ws[vi[1]] - w0, dw2 = ws[vi[2]] - w0;
+	float u0 = us[vi[0]], du1 = us[vi[1]] - u0, du2 = us[vi[2]] - u0;
+	float v0 = vs[vi[0]], dv1 = vs[vi[1]] - v0, dv2 = vs[vi[2]] - v0;
+
+	float awx = (dw1 * dy2 - dw2 * dy1) * fa;
+	float awy = (dw2 * dx1 - dw1 * dx2) * fa;
+	float aux = (du1 * dy2 - du2 * dy1) * fa;
+	float auy = (du2 * dx1 - du1 * dx2) * fa;
+	float avx = (dv1 * dy2 - dv2 * dy1) * fa;
+	float avy = (dv2 * dx1 - dv1 * dx2) * fa;
+
+	__m128 aw_4 = _mm_set_ps(3.0f * awx, 2.0f * awx, awx, 0.0f);
+	__m128 au_4 = _mm_set_ps(3.0f * aux, 2.0f * aux, aux, 0.0f);
+	__m128 av_4 = _mm_set_ps(3.0f * avx, 2.0f * avx, avx, 0.0f);
+
+	__m128i ex_4[3];
+	for (int k = 0; k < 3; k++)
+		ex_4[k] = _mm_set_epi32(3 * ex[k], 2 * ex[k], ex[k], 0);
+	__m128i lane_4 = _mm_set_epi32(3, 2, 1, 0);
+	__m128i none_4 = _mm_set1_epi32(-1);
+	__m128i zv = _mm_set1_epi32(0);
+
+// Walk the 4x4 pixel blocks
+	for (int by = by1; by < by2; by += 4) {
+		int ye = cmmin(by + 4, by2);
+		for (int bx = bx1; bx < bx2; bx += 4) {
+			int ebk[3];
+			bool accept = bx + 4 <= bx2 && ye == by + 4;
+			bool reject = false;
+			for (int k = 0; k < 3; k++) {
+				int64_t e = eo[k] + (int64_t) ex[k] * (bx - bx1) + (int64_t) ey[k] * (by - by1);
+				int64_t emax = e + cmmax(0, 3 * ex[k]) + cmmax(0, 3 * ey[k]);
+				int64_t emin = e + cmmin(0, 3 * ex[k]) + cmmin(0, 3 * ey[k]);
+				if (emax < 0) {reject = true; break;}
+				if (emin < 0) accept = false;
+				e = cmmin(e, (int64_t) 1 << 30);
+				e = cmmax(e, -((int64_t) 1 << 30));
+				ebk[k] = (int) e;
+			}
+			if (reject) continue;
+
+		// Columns inside the bounding box
+			__m128i col_4 = _mm_cmplt_epi32(lane_4, _mm_set1_epi32(bx2 - bx));
+
+			for (int y = by; y < ye; y++) {
+				int j = y - by;
+				int m = 0xF;
+				if (!accept) {
+					__m128i e0_4 = _mm_add_epi32(_mm_set1_epi32(ebk[0] + ey[0] * j), ex_4[0]);
+					__m128i e1_4 = _mm_add_epi32(_mm_set1_epi32(ebk[1] + ey[1] * j), ex_4[1]);
+					__m128i e2_4 = _mm_add_epi32(_mm_set1_epi32(ebk[2] + ey[2] * j), ex_4[2]);
+					__m128i mask_4 = _mm_and_si128(col_4, _mm_cmpgt_epi32(e0_4, none_4));
+					mask_4 = _mm_and_si128(mask_4, _mm_cmpgt_epi32(e1_4, none_4));
+					mask_4 = _mm_and_si128(mask_4, _mm_cmpgt_epi32(e2_4, none_4));
+					m = _mm_movemask_ps(_mm_castsi128_ps(mask_4));
+					if (!m) continue;
+				}
+
+				float xo = (float) (bx - ix[0]);
+				float yo = (float) (y - iy[0]);
+				__m128 w_4 = _mm_add_ps(_mm_set1_ps(w0 + awx * xo + awy * yo), aw_4);
+				__m128 u_4 = _mm_add_ps(_mm_set1_ps(u0 + aux * xo + auy * yo), au_4);
+				__m128 v_4 = _mm_add_ps(_mm_set1_ps(v0 + avx * xo + avy * yo), av_4);
+				__m128 z_4 = _mm_rcp_ps(w_4);
+
+				__m128 mu_4, mv_4;
+				mu_4 = _mm_mul_ps(u_4, z_4);
+				mv_4 = _mm_mul_ps(v_4, z_4);
+				mv_4 = _mm_mul_ps(mv_4, texScale_4);
+
+				__m128i mui_4, mvi_4;
+				mui_4 = _mm_cvtps_epi32(mu_4);
+				mvi_4 = _mm_cvtps_epi32(mv_4);
+#if LE_TEXTURE_TILING == 1
+				__m128i tui_4, tvi_4;
+				tui_4 = _mm_and_si128(mui_4, texTileMaskU_4);
+				tvi_4 = _mm_and_si128(_mm_srl_epi32(mvi_4, texTileShiftU_4), texTileMaskV_4);
+				mui_4 = _mm_and_si128(_mm_sll_epi32(mui_4, texTileShiftV_4), texMaskU_4);
+				mvi_4 = _mm_and_si128(mvi_4, texMaskV_4);
+				mui_4 = _mm_add_epi32(_mm_add_epi32(mui_4, tui_4), _mm_add_epi32(mvi_4, tvi_4));
+#else
+				mui_4 = _mm_and_si128(mui_4, texMaskU_4);
+				mvi_4 = _mm_and_si128(mvi_4, texMaskV_4);
+				mui_4 = _mm_add_epi32(mui_4, mvi_4);
+#endif // LE_TEXTURE_TILING
+
+				uint32_t mi[4];
+				_mm_storeu_si128((__m128i *) mi, mui_4);
+
+				__m128i tp, tq, t1, t2;
+				tp = _mm_loadl_epi64((__m128i *) &texDiffusePixels[mi[0]]);
+				tq = _mm_loadl_epi64((__m128i *) &texDiffusePixels[mi[1]]);
+				t1 = _mm_unpacklo_epi32(tp, tq);
+				t1 = _mm_unpacklo_epi8(t1, zv);
+				t1 = _mm_mullo_epi16(t1, color_4);
+				t1 = _mm_srli_epi16(t1, 8);
+
+				tp = _mm_loadl_epi64((__m128i *) &texDiffusePixels[mi[2]]);
+				tq = _mm_loadl_epi64((__m128i *) &texDiffusePixels[mi[3]]);
+				t2 = _mm_unpacklo_epi32(tp, tq);
+				t2 = _mm_unpacklo_epi8(t2, zv);
+				t2 = _mm_mullo_epi16(t2, color_4);
+				t2 = _mm_srli_epi16(t2, 8);
+				tp = _mm_packus_epi16(t1, t2);
+
+			// Store the covered pixels (never touch the pixels outside)
+				LeColor * p = bx + y * frame.tx + pixels;
+				if (m == 0xF) {
+					_mm_storeu_si128((__m128i *) p, tp);
+				}else{
+					uint32_t c[4];
+					_mm_storeu_si128((__m128i *) c, tp);
+					for (int i = 0; i < 4; i++)
+						if (m & (1 << i)) ((uint32_t *) p)[i] = c[i];
+				}
+			}
+		}
+	}
+}
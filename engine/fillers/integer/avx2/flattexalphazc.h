@@ -0,0 +1,148 @@
+/**
+	\file flattexalphazc.inc
+	\brief LightEngine 3D: Filler (avx2/integer) - flat textured & alpha blended z-corrected scans
+	\brief Intel x86 CPU (with AVX2) implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+inline void LeRasterizer::fillFlatTexAlphaZC(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2)
+{
+	int d = x2 - x1;
+	if (d == 0) return;
+
+	int au = (u2 - u1) / d;
+	int av = (v2 - v1) / d;
+	int aw = (w2 - w1) / d;
+
+	if (x1 < scissorX1) {
+		int s = scissorX1 - x1;
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		x1 = scissorX1;
+	}
+
+	if (++x2 > scissorX2) x2 = scissorX2;
+	if (x2 <= x1) return;
+
+	__m256i r_8 = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+	__m256i u_8 = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(au), r_8), _mm256_set1_epi32(u1));
+	__m256i v_8 = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(av), r_8), _mm256_set1_epi32(v1));
+	__m256i w_8 = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(aw), r_8), _mm256_set1_epi32(w1));
+
+	__m256i au_8 = _mm256_set1_epi32(au * 8);
+	__m256i av_8 = _mm256_set1_epi32(av * 8);
+	__m256i aw_8 = _mm256_set1_epi32(aw * 8);
+
+	__m256 zn_8 = _mm256_set1_ps((float) (1 << 30));
+	__m128i su = _mm_cvtsi32_si128(texSizeU);
+
+	LeColor * p = x1 + y * frame.tx + pixels;
+	int b = (x2 - x1) >> 3;
+	int r = (x2 - x1) & 0x7;
+
+	__m256i texMaskU_8 = _mm256_set1_epi32(texMaskU);
+	__m256i texMaskV_8 = _mm256_set1_epi32(texMaskV);
+#if LE_TEXTURE_TILING == 1
+	__m128i stu = _mm_cvtsi32_si128(texTileU);
+	__m128i stv = _mm_cvtsi32_si128(texTileV);
+	__m256i texTileMaskU_8 = _mm256_set1_epi32(texTileMaskU);
+	__m256i texTileMaskV_8 = _mm256_set1_epi32(texTileMaskV);
+#endif // LE_TEXTURE_TILING
+	__m256i color_8 = _mm256_broadcastsi128_si256(color_4);
+	__m256i zv = _mm256_setzero_si256();
+	__m256i sc = _mm256_set1_epi32(0x01000100);
+	__m256i m_8 = _mm256_cmpgt_epi32(_mm256_set1_epi32(r), r_8);
+
+	for (int x = 0; x <= b; x ++) {
+		if (x == b && r == 0) return;
+		__m256 wf_8 = _mm256_cvtepi32_ps(_mm256_srai_epi32(w_8, 8));
+		__m256i z_8 = _mm256_cvttps_epi32(_mm256_div_ps(zn_8, wf_8));
+
+	// 32x32 -> 64 bit products (even and odd lanes), shifted by 24
+		__m256i mui_8, mvi_8, e, o;
+		e = _mm256_srli_epi64(_mm256_mul_epi32(u_8, z_8), 24);
+		o = _mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(u_8, 32), _mm256_srli_epi64(z_8, 32)), 8);
+		mui_8 = _mm256_blend_epi32(e, o, 0xAA);
+		e = _mm256_srli_epi64(_mm256_mul_epi32(v_8, z_8), 24);
+		o = _mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(v_8, 32), _mm256_srli_epi64(z_8, 32)), 8);
+		mvi_8 = _mm256_blend_epi32(e, o, 0xAA);
+
+#if LE_TEXTURE_TILING == 1
+		__m256i tui_8, tvi_8;
+		mui_8 = _mm256_and_si256(mui_8, texMaskU_8);
+		mvi_8 = _mm256_and_si256(mvi_8, texMaskV_8);
+		tui_8 = _mm256_and_si256(mui_8, texTileMaskU_8);
+		tvi_8 = _mm256_and_si256(mvi_8, texTileMaskV_8);
+		mui_8 = _mm256_sll_epi32(_mm256_sub_epi32(mui_8, tui_8), stv);
+		mvi_8 = _mm256_sll_epi32(_mm256_sub_epi32(mvi_8, tvi_8), su);
+		tvi_8 = _mm256_sll_epi32(tvi_8, stu);
+		mui_8 = _mm256_add_epi32(_mm256_add_epi32(mui_8, tui_8), _mm256_add_epi32(mvi_8, tvi_8));
+#else
+		mui_8 = _mm256_and_si256(mui_8, texMaskU_8);
+		mvi_8 = _mm256_and_si256(mvi_8, texMaskV_8);
+		mvi_8 = _mm256_sll_epi32(mvi_8, su);
+		mui_8 = _mm256_add_epi32(mui_8, mvi_8);
+#endif // LE_TEXTURE_TILING
+
+		__m256i tp, fp, t1, t2, f1, f2, a1, a2;
+		if (x == b) fp = _mm256_maskload_epi32((int *) p, m_8);
+		else fp = _mm256_loadu_si256((__m256i *) p);
+		f1 = _mm256_unpacklo_epi8(fp, zv);
+		f2 = _mm256_unpackhi_epi8(fp, zv);
+		tp = _mm256_i32gather_epi32((const int *) texDiffusePixels, mui_8, 4);
+		t1 = _mm256_unpacklo_epi8(tp, zv);
+		t2 = _mm256_unpackhi_epi8(tp, zv);
+
+		a1 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(t1, 0xFF), 0xFF);
+		a2 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(t2, 0xFF), 0xFF);
+		a1 = _mm256_sub_epi16(sc, a1);
+		a2 = _mm256_sub_epi16(sc, a2);
+
+		t1 = _mm256_mullo_epi16(t1, color_8);
+		t2 = _mm256_mullo_epi16(t2, color_8);
+		f1 = _mm256_mullo_epi16(f1, a1);
+		f2 = _mm256_mullo_epi16(f2, a2);
+		t1 = _mm256_adds_epu16(t1, f1);
+		t2 = _mm256_adds_epu16(t2, f2);
+		t1 = _mm256_srli_epi16(t1, 8);
+		t2 = _mm256_srli_epi16(t2, 8);
+		tp = _mm256_packus_epi16(t1, t2);
+
+		if (x == b) {
+			_mm256_maskstore_epi32((int *) p, m_8, tp);
+			return;
+		}
+		_mm256_storeu_si256((__m256i *) p, tp);
+		p += 8;
+
+		w_8 = _mm256_add_epi32(w_8, aw_8);
+		u_8 = _mm256_add_epi32(u_8, au_8);
+		v_8 = _mm256_add_epi32(v_8, av_8);
+	}
+}
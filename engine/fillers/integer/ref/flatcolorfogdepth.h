@@ -0,0 +1,77 @@
+/**
+	\file flatcolorfogdepth.h
+	\brief LightEngine 3D: Filler (ref/integer) - flat untextured fogged scans (depth tested & written)
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+inline void LeRasterizer::fillFlatColorFogDepth(int y, int x1, int x2, int w1, int w2)
+{
+	uint8_t * sc = (uint8_t *) &curTriangle->solidColor;
+	uint8_t * fc = (uint8_t *) &curTrilist->fog.color;
+
+	int d = x2 - x1;
+	if (d == 0) return;
+
+	int aw = (w2 - w1) / d;
+
+	if (x1 < scissorX1) {
+		int s = scissorX1 - x1;
+		w1 += aw * s;
+		x1 = scissorX1;
+	}
+	if (x2 >= scissorX2) x2 = scissorX2 - 1;
+
+	const float sw = 0x1p8;
+	int32_t znear = (int32_t) (curTrilist->fog.near * sw);
+	int32_t zfar = (int32_t) (curTrilist->fog.far * sw);
+	int32_t zscale = (1 << 30) / (zfar - znear);
+
+	uint8_t * p = (uint8_t *) (x1 + y * frame.tx + pixels);
+	int32_t * zb = x1 + y * frame.tx + depth;
+
+	for (int x = x1; x <= x2; x++) {
+		if (w1 < *zb) {
+			*zb = w1;
+			int32_t z = (1 << 30) / (w1 >> 8);
+			int32_t ff = ((int64_t) (z - znear) * zscale) >> 15;
+			ff = cmmax(0, ff);
+			ff = cmmin((1 << 15), ff);
+			int fb = (ff * ff) >> (14 + 8);
+
+			p[0] = sc[0] + (((fc[0] - sc[0]) * fb) >> 8);
+			p[1] = sc[1] + (((fc[1] - sc[1]) * fb) >> 8);
+			p[2] = sc[2] + (((fc[2] - sc[2]) * fb) >> 8);
+		}
+		p += 4;
+		zb++;
+
+		w1 += aw;
+	}
+}
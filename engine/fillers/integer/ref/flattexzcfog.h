@@ -42,6 +42,15 @@ inline void LeRasterizer::fillFlatTexZCFog(int y, int x1, int x2, int w1, int w2
 	int av = (v2 - v1) / d;
 	int aw = (w2 - w1) / d;
 
+	if (x1 < scissorX1) {
+		int s = scissorX1 - x1;
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		x1 = scissorX1;
+	}
+	if (x2 >= scissorX2) x2 = scissorX2 - 1;
+
 	const float sw = 0x1p8;
 	int32_t znear = (int32_t) (curTrilist->fog.near * sw);
 	int32_t zfar = (int32_t) (curTrilist->fog.far * sw);
@@ -53,7 +62,7 @@ inline void LeRasterizer::fillFlatTexZCFog(int y, int x1, int x2, int w1, int w2
 		int32_t z = (1 << 30) / (w1 >> 8);
 		uint32_t tu = (((int64_t) u1 * z) >> 24) & texMaskU;
 		uint32_t tv = (((int64_t) v1 * z) >> 24) & texMaskV;
-		uint8_t * t = (uint8_t *) &texDiffusePixels[tu + (tv << texSizeU)];
+		uint8_t * t = (uint8_t *) &texDiffusePixels[texelIndex(tu, tv)];
 
 		int r = (t[0] * sc[0]) >> 8;
 		int g = (t[1] * sc[1]) >> 8;
@@ -39,7 +39,15 @@ inline void LeRasterizer::fillFlatTexAlphaZC(int y, int x1, int x2, int w1, int
 	int av = (v2 - v1) / d;
 	int aw = (w2 - w1) / d;
 
-	if (++x2 > frame.tx) x2 = frame.tx;
+	if (x1 < scissorX1) {
+		int s = scissorX1 - x1;
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		x1 = scissorX1;
+	}
+
+	if (++x2 > scissorX2) x2 = scissorX2;
 	LeColor * p = x1 + y * frame.tx + pixels;
 
 	__m128i sc = _mm_set1_epi32(0x01000100);
@@ -51,7 +59,7 @@ inline void LeRasterizer::fillFlatTexAlphaZC(int y, int x1, int x2, int w1, int
 		__m128i zv = _mm_set1_epi32(0);
 		__m128i tp, fp;
 		fp = _mm_loadl_epi64((__m128i *) p);
-		tp = _mm_loadl_epi64((__m128i *) &texDiffusePixels[tu + (tv << texSizeU)]);
+		tp = _mm_loadl_epi64((__m128i *) &texDiffusePixels[texelIndex(tu, tv)]);
 		fp = _mm_unpacklo_epi8(fp, zv);
 		tp = _mm_unpacklo_epi8(tp, zv);
 
@@ -43,19 +43,27 @@ inline void LeRasterizer::fillFlatTexAlphaZCFog(int y, int x1, int x2, int w1, i
 	int av = (v2 - v1) / d;
 	int aw = (w2 - w1) / d;
 
+	if (x1 < scissorX1) {
+		int s = scissorX1 - x1;
+		u1 += au * s;
+		v1 += av * s;
+		w1 += aw * s;
+		x1 = scissorX1;
+	}
+
 	const float sw = 0x1p8;
 	int32_t znear = (int32_t)(curTrilist->fog.near * sw);
 	int32_t zfar = (int32_t)(curTrilist->fog.far * sw);
 	int32_t zscale = (1 << 30) / (zfar - znear);
 
-	if (++x2 > frame.tx) x2 = frame.tx;
+	if (++x2 > scissorX2) x2 = scissorX2;
 	uint8_t * p = (uint8_t *)(x1 + y * frame.tx + pixels);
 
 	for (int x = x1; x < x2; x++) {
 		int32_t z = (1 << 30) / (w1 >> 8);
 		uint32_t tu = (((int64_t)u1 * z) >> 24) & texMaskU;
 		uint32_t tv = (((int64_t)v1 * z) >> 24) & texMaskV;
-		uint8_t * t = (uint8_t *)&texDiffusePixels[tu + (tv << texSizeU)];
+		uint8_t * t = (uint8_t *)&texDiffusePixels[texelIndex(tu, tv)];
 
 		int32_t ff = ((int64_t)(z - znear) * zscale) >> 15;
 		ff = cmmax(0, ff);
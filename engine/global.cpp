@@ -114,6 +114,43 @@ int LeGlobal::log2i32(int n)
 	return r;
 }
 
+/*****************************************************************************/
+#if defined(__i386__) || defined(_M_IX86) || defined(_X86_) || defined(__x86_64__) || defined(_M_X64)
+	#define LE_CPU_X86	1
+#endif
+
+bool LeGlobal::hasSSE2()
+{
+#if defined(LE_CPU_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse2");
+#elif defined(LE_CPU_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[3] & (1 << 26)) != 0;
+#else
+	return false;
+#endif
+}
+
+bool LeGlobal::hasAVX2()
+{
+#if defined(LE_CPU_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(LE_CPU_X86) && defined(_MSC_VER)
+// FMA, OSXSAVE & AVX, then the YMM state saved by the OS, then AVX2
+	int info[4];
+	__cpuid(info, 1);
+	if ((info[2] & 0x18001000) != 0x18001000) return false;
+	if ((_xgetbv(0) & 0x6) != 0x6) return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return false;
+#endif
+}
+
 /*****************************************************************************/
 #ifdef _MSC_VER
 extern "C" int __builtin_ffs(int x) {
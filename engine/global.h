@@ -65,6 +65,9 @@
 		void getFileDirectory(char * dir, int dirSize, const char * path);					/** Return a directory name from a path */
 
 		int log2i32(int n);																	/** Compute the log2 of a 32bit integer */
+
+		bool hasSSE2();																		/** Check if the processor supports Intel SSE2 instructions */
+		bool hasAVX2();																		/** Check if the processor (and OS) supports Intel AVX2 & FMA instructions */
 	};
 
 /*****************************************************************************/
@@ -40,10 +40,12 @@
 	#include "config.h"
 
 	#include "system.h"
+	#include "threads.h"
 	#include "window.h"
 	#include "draw.h"
 	#include "renderer.h"
 	#include "rasterizer.h"
+	#include "pipeline.h"
 	#include "gamepad.h"
 
 	#include "geometry.h"
@@ -52,6 +54,7 @@
 
 	#include "light.h"
 	#include "mesh.h"
+	#include "meshlod.h"
 	#include "bset.h"
 	#include "bitmap.h"
 
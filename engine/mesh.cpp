@@ -37,6 +37,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 /*****************************************************************************/
 LeMesh::LeMesh() :
@@ -46,7 +47,9 @@ LeMesh::LeMesh() :
 	texCoords(NULL), noTexCoords(0),
 	vertexesList(NULL), texCoordsList(NULL), texSlotList(NULL),
 	colors(NULL), noTriangles(0),
-	normals(NULL), shades(NULL),
+	normals(NULL), shades(NULL), positions(NULL), planes(NULL),
+	boundCenter(), boundRadius(-1.0f),
+	boundMin(), boundMax(),
 	allocated(false)
 {
 	memset(name, 0, LE_OBJ_MAX_NAME+1);
@@ -63,11 +66,16 @@ LeMesh::LeMesh(LeVertex vertexes[], int noVertexes,
 	texCoords(texCoords), noTexCoords(noTexCoords),
 	vertexesList(NULL), texCoordsList(NULL), texSlotList(NULL),
 	colors(colors), noTriangles(noTriangles),
-	normals(NULL), shades(NULL),
+	normals(NULL), shades(NULL), positions(NULL), planes(NULL),
+	boundCenter(), boundRadius(-1.0f),
+	boundMin(), boundMax(),
 	allocated(false)
 {
 	memset(name, 0, LE_OBJ_MAX_NAME+1);
 	updateMatrix();
+	computeBounds();
+	computePositions();
+	computePlanes();
 }
 
 LeMesh::~LeMesh()
@@ -105,6 +113,11 @@ void LeMesh::allocate(int noVertexes, int noTexCoords, int noTriangles)
 	memset(colors, 0xFF, sizeof(LeColor) * noTriangles);
 	
 	this->noTriangles = noTriangles;
+	boundRadius = -1.0f;
+	if (positions) delete[] positions;
+	positions = NULL;
+	if (planes) delete[] planes;
+	planes = NULL;
 	allocated = true;
 }
 
@@ -140,6 +153,10 @@ void LeMesh::deallocate()
 	normals = NULL;
 	if (shades) delete shades;
 	shades = NULL;
+	if (positions) delete[] positions;
+	positions = NULL;
+	if (planes) delete[] planes;
+	planes = NULL;
 }
 
 /*****************************************************************************/
@@ -163,6 +180,11 @@ void LeMesh::shadowCopy(LeMesh * copy) const
 	copy->noTriangles = noTriangles;
 	copy->allocated = false;
 
+	copy->boundCenter = boundCenter;
+	copy->boundRadius = boundRadius;
+	copy->boundMin = boundMin;
+	copy->boundMax = boundMax;
+
 	if (normals) {
 		copy->normals = new LeVertex[noTriangles];
 		memcpy(copy->normals, normals, noTriangles * sizeof(LeVertex));
@@ -171,6 +193,15 @@ void LeMesh::shadowCopy(LeMesh * copy) const
 		copy->shades = new LeColor[noTriangles];
 		memcpy(copy->shades, shades, noTriangles * sizeof(LeColor));
 	}
+	if (positions) {
+		int stride = (noVertexes + 7) & ~7;
+		copy->positions = new float[stride * 3];
+		memcpy(copy->positions, positions, stride * 3 * sizeof(float));
+	}
+	if (planes) {
+		copy->planes = new LeVertex[noTriangles];
+		memcpy(copy->planes, planes, noTriangles * sizeof(LeVertex));
+	}
 }
 
 /**
@@ -191,6 +222,11 @@ void LeMesh::copy(LeMesh * copy) const
 	memcpy(copy->texSlotList, texSlotList, noTriangles * sizeof(int));
 	memcpy(copy->colors, colors, noTriangles * sizeof(uint32_t));
 
+	copy->boundCenter = boundCenter;
+	copy->boundRadius = boundRadius;
+	copy->boundMin = boundMin;
+	copy->boundMax = boundMax;
+
 	if (normals) {
 		copy->normals = new LeVertex[noTriangles];
 		memcpy(copy->normals, normals, noTriangles * sizeof(LeVertex));
@@ -199,6 +235,15 @@ void LeMesh::copy(LeMesh * copy) const
 		copy->shades = new LeColor[noTriangles];
 		memcpy(copy->shades, shades, noTriangles * sizeof(LeColor));
 	}
+	if (positions) {
+		int stride = (noVertexes + 7) & ~7;
+		copy->positions = new float[stride * 3];
+		memcpy(copy->positions, positions, stride * 3 * sizeof(float));
+	}
+	if (planes) {
+		copy->planes = new LeVertex[noTriangles];
+		memcpy(copy->planes, planes, noTriangles * sizeof(LeVertex));
+	}
 }
 
 /*****************************************************************************/
@@ -255,6 +300,84 @@ void LeMesh::computeNormals()
 	}
 }
 
+/*****************************************************************************/
+/**
+	\fn void LeMesh::computeBounds()
+	\brief Compute mesh bounding box and bounding sphere (for culling)
+*/
+void LeMesh::computeBounds()
+{
+	if (!vertexes || !noVertexes) {
+		boundRadius = -1.0f;
+		return;
+	}
+
+	boundMin = vertexes[0];
+	boundMax = vertexes[0];
+	for (int i = 1; i < noVertexes; i++) {
+		LeVertex * v = &vertexes[i];
+		boundMin.x = cmmin(boundMin.x, v->x);
+		boundMin.y = cmmin(boundMin.y, v->y);
+		boundMin.z = cmmin(boundMin.z, v->z);
+		boundMax.x = cmmax(boundMax.x, v->x);
+		boundMax.y = cmmax(boundMax.y, v->y);
+		boundMax.z = cmmax(boundMax.z, v->z);
+	}
+
+	boundCenter = (boundMin + boundMax) * 0.5f;
+	float r2 = 0.0f;
+	for (int i = 0; i < noVertexes; i++) {
+		LeVertex d = vertexes[i] - boundCenter;
+		r2 = cmmax(r2, d.dot(d));
+	}
+	boundRadius = sqrtf(r2);
+}
+
+/**
+	\fn void LeMesh::computePositions()
+	\brief Compute the vertex positions stream (for batched transforms)
+*/
+void LeMesh::computePositions()
+{
+	if (positions) delete[] positions;
+	positions = NULL;
+	if (!vertexes || !noVertexes) return;
+
+	int stride = (noVertexes + 7) & ~7;
+	positions = new float[stride * 3];
+	memset(positions, 0, stride * 3 * sizeof(float));
+
+	float * xs = positions;
+	float * ys = positions + stride;
+	float * zs = positions + stride * 2;
+	for (int i = 0; i < noVertexes; i++) {
+		xs[i] = vertexes[i].x;
+		ys[i] = vertexes[i].y;
+		zs[i] = vertexes[i].z;
+	}
+}
+
+/**
+	\fn void LeMesh::computePlanes()
+	\brief Compute the face plane equations (for object space backculling)
+*/
+void LeMesh::computePlanes()
+{
+	if (planes) delete[] planes;
+	planes = NULL;
+	if (!vertexes || !vertexesList || !noTriangles) return;
+
+	planes = new LeVertex[noTriangles];
+	for (int i = 0; i < noTriangles; i++) {
+		LeVertex v1 = vertexes[vertexesList[i*3]];
+		LeVertex v2 = vertexes[vertexesList[i*3+1]];
+		LeVertex v3 = vertexes[vertexesList[i*3+2]];
+		LeVertex n = (v2 - v1).cross(v3 - v1);
+		planes[i] = n;
+		planes[i].w = -n.dot(v1);
+	}
+}
+
 /*****************************************************************************/
 /**
 	\fn void LeMesh::allocateNormals()
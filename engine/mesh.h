@@ -64,6 +64,9 @@ public:
 	void updateMatrix();
 
 	void computeNormals();
+	void computeBounds();
+	void computePositions();
+	void computePlanes();
 	void allocateNormals();
 	void allocateShades();
 	
@@ -88,6 +91,13 @@ public:
 // Computed mesh data
 	LeVertex * normals;					/** Normal vector per triangle */
 	LeColor * shades;					/** Shade color per triangle (lighting) */
+	float * positions;					/** Vertex positions stream (x, y, z blocks padded to 8 vertexes) */
+	LeVertex * planes;					/** Face plane equation per triangle (normal in x, y, z and distance in w) */
+
+	LeVertex boundCenter;				/** Bounding sphere center (object space) */
+	float boundRadius;					/** Bounding sphere radius (negative if not computed) */
+	LeVertex boundMin;					/** Bounding box minimum corner (object space) */
+	LeVertex boundMax;					/** Bounding box maximum corner (object space) */
 
 	bool allocated;						/** Has data been allocated */
 };
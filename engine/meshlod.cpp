@@ -0,0 +1,117 @@
+/**
+	\file meshlod.cpp
+	\brief LightEngine 3D: Mesh levels of detail container
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frédéric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "meshlod.h"
+
+#include "global.h"
+#include "config.h"
+
+#include <string.h>
+
+/*****************************************************************************/
+LeMeshLOD::LeMeshLOD() :
+	view(),
+	pos(), scale(1.0f, 1.0f, 1.0f), angle(),
+	noLevels(0)
+{
+	memset(levels, 0, sizeof(levels));
+	memset(sizes, 0, sizeof(sizes));
+	updateMatrix();
+}
+
+LeMeshLOD::~LeMeshLOD()
+{
+}
+
+/*****************************************************************************/
+/**
+	\fn bool LeMeshLOD::addLevel(LeMesh * mesh, float size)
+	\brief Append a level to the chain (levels are added from the most detailed)
+	\param[in] mesh pointer to the level mesh (not owned by the chain)
+	\param[in] size minimum projected bounding sphere radius to use the level (in pixels)
+	\return true if the level was added, false if the chain is full
+*/
+bool LeMeshLOD::addLevel(LeMesh * mesh, float size)
+{
+	if (noLevels >= LE_MESHLOD_MAX_LEVELS) return false;
+	levels[noLevels] = mesh;
+	sizes[noLevels] = size;
+	noLevels++;
+	return true;
+}
+
+/**
+	\fn void LeMeshLOD::clear()
+	\brief Remove all the levels from the chain
+*/
+void LeMeshLOD::clear()
+{
+	memset(levels, 0, sizeof(levels));
+	memset(sizes, 0, sizeof(sizes));
+	noLevels = 0;
+}
+
+/**
+	\fn const LeMesh * LeMeshLOD::getLevel(float size) const
+	\brief Select the level matching a projected size
+	\param[in] size projected bounding sphere radius (in pixels)
+	\return pointer to the level mesh, NULL if smaller than the last level
+*/
+const LeMesh * LeMeshLOD::getLevel(float size) const
+{
+	for (int i = 0; i < noLevels; i++)
+		if (size >= sizes[i]) return levels[i];
+	return NULL;
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeMeshLOD::setMatrix(const LeMatrix &matrix)
+	\brief Set the chain view matrix
+	\param[in] matrix view matrix
+*/
+void LeMeshLOD::setMatrix(const LeMatrix &matrix)
+{
+	view = matrix;
+}
+
+/**
+	\fn void LeMeshLOD::updateMatrix()
+	\brief Update the chain view matrix with position, scaling and angle vectors
+*/
+void LeMeshLOD::updateMatrix()
+{
+	view.identity();
+	view.scale(scale);
+	view.rotateEulerZYX(angle * d2r);
+	view.translate(pos);
+}
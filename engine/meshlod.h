@@ -0,0 +1,73 @@
+/**
+	\file meshlod.h
+	\brief LightEngine 3D: Mesh levels of detail container
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frédéric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef LE_MESHLOD_H
+#define LE_MESHLOD_H
+
+#include "global.h"
+#include "config.h"
+
+#include "geometry.h"
+#include "mesh.h"
+
+/*****************************************************************************/
+/**
+	\class LeMeshLOD
+	\brief Chain of mesh levels of detail (selected by their projected size)
+*/
+class LeMeshLOD
+{
+public:
+	LeMeshLOD();
+	~LeMeshLOD();
+
+	bool addLevel(LeMesh * mesh, float size);
+	void clear();
+
+	const LeMesh * getLevel(float size) const;
+
+	void setMatrix(const LeMatrix &matrix);
+	void updateMatrix();
+
+// Overall positioning
+	LeMatrix view;								/**< View matrix of the chain */
+	LeVertex pos;								/**< Position of the chain */
+	LeVertex scale;								/**< Scaling of the chain */
+	LeVertex angle;								/**< Absolute angle of the chain (in degrees) */
+
+// Levels of detail
+	LeMesh * levels[LE_MESHLOD_MAX_LEVELS];		/**< Meshes of the levels (most detailed first) */
+	float sizes[LE_MESHLOD_MAX_LEVELS];			/**< Minimum projected radius of the levels (in pixels) */
+	int noLevels;								/**< Number of levels in the chain */
+};
+
+#endif // LE_MESHLOD_H
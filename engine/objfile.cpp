@@ -81,6 +81,9 @@ LeMesh * LeObjFile::load(int index)
 				mesh->name[LE_OBJ_MAX_NAME] = '\0';
 				importMeshAllocate(file, mesh);
 				importMeshData(file, mesh);
+				mesh->computeBounds();
+				mesh->computePositions();
+				mesh->computePlanes();
 				break;
 			}
 		}
@@ -0,0 +1,247 @@
+/**
+	\file pipeline.cpp
+	\brief LightEngine 3D: Frame pipeline (geometry and rasterization overlapped)
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frédéric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "pipeline.h"
+
+#include "global.h"
+#include "config.h"
+
+#include <stdlib.h>
+
+/*****************************************************************************/
+LePipeline::LePipeline(LeRenderer * renderer, LeRasterizer * rasterizer) :
+	renderer(renderer),
+	rasterizer(rasterizer),
+	geometry(NULL),
+	geometryData(NULL),
+	presented(),
+	pixels(rasterizer->getPixels()),
+	pool(),
+	latency(0),
+	noFrames(0),
+	geometryFence(-1),
+	rasterFence(-1),
+	pendingGeometry(-1),
+	pendingRaster(-1)
+{
+	presented.allocate(rasterizer->frame.tx, rasterizer->frame.ty);
+	setLatency(2);
+}
+
+LePipeline::~LePipeline()
+{
+	sync();
+	pool.stop();
+	renderer->setTriangleList(NULL);
+}
+
+/*****************************************************************************/
+/**
+	\fn void LePipeline::setGeometry(Stage stage, void * data)
+	\brief Set the geometry stage of the frames
+	\param[in] stage callback rendering a frame (called with data, the renderer and the frame number)
+	\param[in] data callback data
+
+	The callback runs on a pipeline thread with latencies above 1:
+	it must only render (and update the objects of) the given frame.
+*/
+void LePipeline::setGeometry(Stage stage, void * data)
+{
+	sync();
+	geometry = stage;
+	geometryData = data;
+}
+
+/**
+	\fn void LePipeline::setLatency(int frames)
+	\brief Set the latency budget (frames in flight)
+	\param[in] frames 1 (serial), 2 (geometry overlapped) or 3 (geometry and rasterization overlapped)
+*/
+void LePipeline::setLatency(int frames)
+{
+	frames = cmmax(1, cmmin(frames, 3));
+	if (frames == latency) return;
+	sync();
+	latency = frames;
+	pool.start(latency);
+}
+
+/**
+	\fn int LePipeline::getLatency()
+	\brief Get the latency budget
+	\return number of frames in flight
+*/
+int LePipeline::getLatency()
+{
+	return latency;
+}
+
+/**
+	\fn void LePipeline::setSortMode(LE_TRILIST_SORT_MODES mode)
+	\brief Set the sorting strategy of the triangle lists
+	\param[in] mode sorting strategy
+
+	Each list holds one frame out of two: the coherent sort
+	is seeded with the order of the frame before the previous one.
+*/
+void LePipeline::setSortMode(LE_TRILIST_SORT_MODES mode)
+{
+	sync();
+	trilists[0].setSortMode(mode);
+	trilists[1].setSortMode(mode);
+}
+
+/*****************************************************************************/
+/**
+	\fn int LePipeline::step()
+	\brief Advance the pipeline by one frame
+	\return number of the frame ready to present (see getPixels())
+*/
+int LePipeline::step()
+{
+	sync();
+	int frame = noFrames++;
+
+// Complete the frame if it is not in the pipeline yet (first frames, latency changes)
+	if (geometryFence < frame) {
+		runGeometry(frame);
+		geometryFence = frame;
+	}
+
+	if (latency == 1) {
+		if (rasterFence < frame) {
+			runRaster(frame);
+			rasterFence = frame;
+		}
+		pixels = rasterizer->getPixels();
+		return frame;
+	}
+
+	if (latency == 2) {
+	// Geometry of the next frame during rasterization and presentation
+		if (geometryFence < frame + 1) {
+			pendingGeometry = frame + 1;
+			pool.runAsync(stageJob, this, 1);
+		}
+		if (rasterFence < frame) {
+			runRaster(frame);
+			rasterFence = frame;
+		}
+		pixels = rasterizer->getPixels();
+		return frame;
+	}
+
+// Present the frame from the second buffer while the next one is rasterized
+	if (rasterFence < frame) {
+		runRaster(frame);
+		rasterFence = frame;
+	}
+	rasterizer->swapFrame(&presented);
+	pixels = presented.data;
+
+	if (geometryFence < frame + 1) {
+		runGeometry(frame + 1);
+		geometryFence = frame + 1;
+	}
+	pendingGeometry = frame + 2;
+	pendingRaster = frame + 1;
+	pool.runAsync(stageJob, this, 2);
+	return frame;
+}
+
+/**
+	\fn const void * LePipeline::getPixels()
+	\brief Get the pixels of the frame returned by step()
+	\return pointer to the frame pixels (valid until the next step)
+*/
+const void * LePipeline::getPixels()
+{
+	return pixels;
+}
+
+/*****************************************************************************/
+/**
+	\fn void LePipeline::sync()
+	\brief Wait for the frames in flight (renderer and rasterizer released)
+*/
+void LePipeline::sync()
+{
+	pool.wait();
+	if (pendingGeometry >= 0) geometryFence = pendingGeometry;
+	if (pendingRaster >= 0) rasterFence = pendingRaster;
+	pendingGeometry = -1;
+	pendingRaster = -1;
+}
+
+/**
+	\fn void LePipeline::waitFence(int frame)
+	\brief Wait until a frame is rasterized
+	\param[in] frame frame number (returns immediately for frames not started yet)
+*/
+void LePipeline::waitFence(int frame)
+{
+	if (frame > rasterFence) sync();
+}
+
+/**
+	\fn int LePipeline::getFence()
+	\brief Get the last frame known to be rasterized
+	\return frame number (-1 if none)
+*/
+int LePipeline::getFence()
+{
+	return rasterFence;
+}
+
+/*****************************************************************************/
+void LePipeline::stageJob(void * data, int index)
+{
+	LePipeline * pipeline = (LePipeline *) data;
+	if (index == 0) pipeline->runGeometry(pipeline->pendingGeometry);
+	else pipeline->runRaster(pipeline->pendingRaster);
+}
+
+void LePipeline::runGeometry(int frame)
+{
+// Carry the fog model (stored in the triangle list)
+	LeTriList * trilist = &trilists[frame & 1];
+	trilist->fog = renderer->getTriangleList()->fog;
+	renderer->setTriangleList(trilist);
+	renderer->flush();
+	if (geometry) geometry(geometryData, renderer, frame);
+}
+
+void LePipeline::runRaster(int frame)
+{
+	rasterizer->flush();
+	rasterizer->rasterList(&trilists[frame & 1]);
+}
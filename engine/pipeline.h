@@ -0,0 +1,104 @@
+/**
+	\file pipeline.h
+	\brief LightEngine 3D: Frame pipeline (geometry and rasterization overlapped)
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frédéric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef LE_PIPELINE_H
+#define LE_PIPELINE_H
+
+#include "global.h"
+#include "config.h"
+
+#include "renderer.h"
+#include "rasterizer.h"
+#include "trilist.h"
+#include "bitmap.h"
+#include "threads.h"
+
+/*****************************************************************************/
+/**
+	\class LePipeline
+	\brief Overlap the geometry and the rasterization of consecutive frames
+
+	The geometry stage (a callback rendering the meshes of a frame) fills
+	one of two triangle lists while the other one is rasterized.
+	The latency budget selects how many frames are in flight:
+	- 1: geometry, rasterization then presentation (serial)
+	- 2: geometry of frame N + 1 during rasterization of frame N (default)
+	- 3: geometry of frame N + 2 and rasterization of frame N + 1
+	  during presentation of frame N (double buffered frame buffer)
+
+	While frames are in flight, the renderer and the rasterizer belong
+	to the pipeline threads: call sync() before changing them.
+*/
+class LePipeline
+{
+public:
+	typedef void (* Stage) (void * data, LeRenderer * renderer, int frame);
+
+	LePipeline(LeRenderer * renderer, LeRasterizer * rasterizer);
+	~LePipeline();
+
+	void setGeometry(Stage stage, void * data);
+	void setLatency(int frames);
+	int getLatency();
+	void setSortMode(LE_TRILIST_SORT_MODES mode);
+
+	int step();
+	const void * getPixels();
+
+	void sync();
+	void waitFence(int frame);
+	int getFence();
+
+private:
+	static void stageJob(void * data, int index);
+	void runGeometry(int frame);
+	void runRaster(int frame);
+
+	LeRenderer * renderer;			/**< Renderer of the geometry stage */
+	LeRasterizer * rasterizer;		/**< Rasterizer of the raster stage */
+	Stage geometry;					/**< Geometry stage callback */
+	void * geometryData;			/**< Geometry stage callback data */
+
+	LeTriList trilists[2];			/**< Triangle lists (even and odd frames) */
+	LeBitmap presented;				/**< Frame buffer being presented (latency 3) */
+	const void * pixels;			/**< Pixels of the last frame stepped */
+
+	LeThreadPool pool;				/**< Pipeline stage threads */
+	int latency;					/**< Latency budget (frames in flight) */
+	int noFrames;					/**< Next frame to present */
+	int geometryFence;				/**< Last frame with its triangle list complete */
+	int rasterFence;				/**< Last frame rasterized */
+	int pendingGeometry;			/**< Frame of the geometry job in flight (-1 if none) */
+	int pendingRaster;				/**< Frame of the raster job in flight (-1 if none) */
+};
+
+#endif // LE_PIPELINE_H
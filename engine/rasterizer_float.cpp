@@ -45,33 +45,252 @@
 #include <string.h>
 #include <float.h>
 
+/*****************************************************************************/
+/** Texel addressing (row ordered or tiled textures) */
+inline uint32_t LeRasterizer::texelIndex(uint32_t tu, uint32_t tv)
+{
+#if LE_TEXTURE_TILING == 1
+	uint32_t lu = tu & texTileMaskU;
+	uint32_t lv = tv & texTileMaskV;
+	return lu + ((tu - lu) << texTileV) + (lv << texTileU) + ((tv - lv) << texSizeU);
+#else
+	return tu + (tv << texSizeU);
+#endif // LE_TEXTURE_TILING
+}
+
 /*****************************************************************************/
 /** Platform specific or reference fillers */
-#if LE_USE_SIMD == 1 && LE_USE_SSE2 == 1
+#if LE_RASTERIZER_DISPATCH == 1
+// Reference and SSE2 fillers (AVX2 ones in rasterizer_float_avx2.cpp)
+	#define fillFlatTexZC				fillFlatTexZCRef
+	#define fillFlatTexZCFog			fillFlatTexZCFogRef
+	#define fillFlatTexAlphaZC			fillFlatTexAlphaZCRef
+	#define fillFlatTexAlphaZCFog		fillFlatTexAlphaZCFogRef
+	#define fillFlatTexZCDepth			fillFlatTexZCDepthRef
+	#define fillFlatTexCutoutZC			fillFlatTexCutoutZCRef
+	#define fillHalfSpaceTexZC			fillHalfSpaceTexZCRef
+	#define fillFlatColor				fillFlatColorRef
+	#include "fillers/float/ref/flattexzc.h"
+	#include "fillers/float/ref/flattexzcfog.h"
+	#include "fillers/float/ref/flattexalphazc.h"
+	#include "fillers/float/ref/flattexalphazcfog.h"
+	#include "fillers/float/ref/flattexzcdepth.h"
+	#include "fillers/float/ref/flattexcutoutzc.h"
+	#include "fillers/float/ref/halfspacetexzc.h"
+	#include "fillers/float/ref/flatcolor.h"
+	#undef fillFlatTexZC
+	#undef fillFlatTexZCFog
+	#undef fillFlatTexAlphaZC
+	#undef fillFlatTexAlphaZCFog
+	#undef fillFlatTexZCDepth
+	#undef fillFlatTexCutoutZC
+	#undef fillHalfSpaceTexZC
+	#undef fillFlatColor
+	#define fillFlatTexZC				fillFlatTexZCSSE
+	#define fillFlatTexZCFog			fillFlatTexZCFogSSE
+	#define fillFlatTexAlphaZC			fillFlatTexAlphaZCSSE
+	#define fillFlatTexAlphaZCFog		fillFlatTexAlphaZCFogSSE
+	#define fillFlatTexZCDepth			fillFlatTexZCDepthSSE
+	#define fillFlatTexCutoutZC			fillFlatTexCutoutZCSSE
+	#define fillHalfSpaceTexZC			fillHalfSpaceTexZCSSE
+	#define fillFlatColor				fillFlatColorSSE
 	#include "fillers/float/sse/flattexzc.h"
 	#include "fillers/float/sse/flattexzcfog.h"
 	#include "fillers/float/sse/flattexalphazc.h"
 	#include "fillers/float/sse/flattexalphazcfog.h"
+	#include "fillers/float/sse/flattexzcdepth.h"
+	#include "fillers/float/sse/flattexcutoutzc.h"
+	#include "fillers/float/sse/halfspacetexzc.h"
+	#include "fillers/float/sse/flatcolor.h"
+	#undef fillFlatTexZC
+	#undef fillFlatTexZCFog
+	#undef fillFlatTexAlphaZC
+	#undef fillFlatTexAlphaZCFog
+	#undef fillFlatTexZCDepth
+	#undef fillFlatTexCutoutZC
+	#undef fillHalfSpaceTexZC
+	#undef fillFlatColor
+	#include "fillers/float/ref/flattexzcfogdepth.h"
+	#include "fillers/float/ref/flattexalphazcdepth.h"
+	#include "fillers/float/ref/flattexalphazcfogdepth.h"
+	#include "fillers/float/ref/flattexsubzc.h"
+	#include "fillers/float/ref/flattexcutoutzcfog.h"
+	#include "fillers/float/ref/flatcolorfog.h"
+	#include "fillers/float/ref/flatcolordepth.h"
+	#include "fillers/float/ref/flatcolorfogdepth.h"
+	#include "fillers/float/ref/flatcoloralpha.h"
+	#include "fillers/float/ref/flatcoloralphafog.h"
+	#include "fillers/float/ref/flatvisibility.h"
+#elif LE_USE_SIMD == 1 && LE_USE_SSE2 == 1 && LE_USE_AVX2 == 1
+	#include "fillers/float/avx2/flattexzc.h"
+	#include "fillers/float/avx2/flattexzcfog.h"
+	#include "fillers/float/avx2/flattexalphazc.h"
+	#include "fillers/float/avx2/flattexalphazcfog.h"
+	#include "fillers/float/sse/flattexzcdepth.h"
+	#include "fillers/float/ref/flattexzcfogdepth.h"
+	#include "fillers/float/ref/flattexalphazcdepth.h"
+	#include "fillers/float/ref/flattexalphazcfogdepth.h"
+	#include "fillers/float/ref/flattexsubzc.h"
+	#include "fillers/float/avx2/flattexcutoutzc.h"
+	#include "fillers/float/ref/flattexcutoutzcfog.h"
+	#include "fillers/float/avx2/halfspacetexzc.h"
+	#include "fillers/float/sse/flatcolor.h"
+	#include "fillers/float/ref/flatcolorfog.h"
+	#include "fillers/float/ref/flatcolordepth.h"
+	#include "fillers/float/ref/flatcolorfogdepth.h"
+	#include "fillers/float/ref/flatcoloralpha.h"
+	#include "fillers/float/ref/flatcoloralphafog.h"
+	#include "fillers/float/ref/flatvisibility.h"
+#elif LE_USE_SIMD == 1 && LE_USE_SSE2 == 1
+	#include "fillers/float/sse/flattexzc.h"
+	#include "fillers/float/sse/flattexzcfog.h"
+	#include "fillers/float/sse/flattexalphazc.h"
+	#include "fillers/float/sse/flattexalphazcfog.h"
+	#include "fillers/float/sse/flattexzcdepth.h"
+	#include "fillers/float/ref/flattexzcfogdepth.h"
+	#include "fillers/float/ref/flattexalphazcdepth.h"
+	#include "fillers/float/ref/flattexalphazcfogdepth.h"
+	#include "fillers/float/ref/flattexsubzc.h"
+	#include "fillers/float/sse/flattexcutoutzc.h"
+	#include "fillers/float/ref/flattexcutoutzcfog.h"
+	#include "fillers/float/sse/halfspacetexzc.h"
+	#include "fillers/float/sse/flatcolor.h"
+	#include "fillers/float/ref/flatcolorfog.h"
+	#include "fillers/float/ref/flatcolordepth.h"
+	#include "fillers/float/ref/flatcolorfogdepth.h"
+	#include "fillers/float/ref/flatcoloralpha.h"
+	#include "fillers/float/ref/flatcoloralphafog.h"
+	#include "fillers/float/ref/flatvisibility.h"
 #elif LE_USE_SIMD == 1 && LE_USE_AMMX == 1
 	#include "fillers/float/ammx/flattexzc.h"
 	#include "fillers/float/ref/flattexzcfog.h"
 	#include "fillers/float/ref/flattexalphazc.h"
 	#include "fillers/float/ref/flattexalphazcfog.h"
+	#include "fillers/float/ref/flattexzcdepth.h"
+	#include "fillers/float/ref/flattexzcfogdepth.h"
+	#include "fillers/float/ref/flattexalphazcdepth.h"
+	#include "fillers/float/ref/flattexalphazcfogdepth.h"
+	#include "fillers/float/ref/flattexsubzc.h"
+	#include "fillers/float/ref/flattexcutoutzc.h"
+	#include "fillers/float/ref/flattexcutoutzcfog.h"
+	#include "fillers/float/ref/halfspacetexzc.h"
+	#include "fillers/float/ref/flatcolor.h"
+	#include "fillers/float/ref/flatcolorfog.h"
+	#include "fillers/float/ref/flatcolordepth.h"
+	#include "fillers/float/ref/flatcolorfogdepth.h"
+	#include "fillers/float/ref/flatcoloralpha.h"
+	#include "fillers/float/ref/flatcoloralphafog.h"
+	#include "fillers/float/ref/flatvisibility.h"
 #else
 	#include "fillers/float/ref/flattexzc.h"
 	#include "fillers/float/ref/flattexzcfog.h"
 	#include "fillers/float/ref/flattexalphazc.h"
 	#include "fillers/float/ref/flattexalphazcfog.h"
+	#include "fillers/float/ref/flattexzcdepth.h"
+	#include "fillers/float/ref/flattexzcfogdepth.h"
+	#include "fillers/float/ref/flattexalphazcdepth.h"
+	#include "fillers/float/ref/flattexalphazcfogdepth.h"
+	#include "fillers/float/ref/flattexsubzc.h"
+	#include "fillers/float/ref/flattexcutoutzc.h"
+	#include "fillers/float/ref/flattexcutoutzcfog.h"
+	#include "fillers/float/ref/halfspacetexzc.h"
+	#include "fillers/float/ref/flatcolor.h"
+	#include "fillers/float/ref/flatcolorfog.h"
+	#include "fillers/float/ref/flatcolordepth.h"
+	#include "fillers/float/ref/flatcolorfogdepth.h"
+	#include "fillers/float/ref/flatcoloralpha.h"
+	#include "fillers/float/ref/flatcoloralphafog.h"
+	#include "fillers/float/ref/flatvisibility.h"
+#endif
+
+/*****************************************************************************/
+/** Span fillers selected at runtime or built-in implementation */
+#if LE_RASTERIZER_DISPATCH == 1
+inline void LeRasterizer::fillFlatTexZC(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	(this->*spanFlatTexZC)(y, x1, x2, w1, w2, u1, u2, v1, v2);
+}
+
+inline void LeRasterizer::fillFlatTexZCFog(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	(this->*spanFlatTexZCFog)(y, x1, x2, w1, w2, u1, u2, v1, v2);
+}
+
+inline void LeRasterizer::fillFlatTexAlphaZC(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	(this->*spanFlatTexAlphaZC)(y, x1, x2, w1, w2, u1, u2, v1, v2);
+}
+
+inline void LeRasterizer::fillFlatTexAlphaZCFog(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	(this->*spanFlatTexAlphaZCFog)(y, x1, x2, w1, w2, u1, u2, v1, v2);
+}
+
+inline void LeRasterizer::fillFlatTexZCDepth(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	(this->*spanFlatTexZCDepth)(y, x1, x2, w1, w2, u1, u2, v1, v2);
+}
+
+inline void LeRasterizer::fillFlatTexCutoutZC(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	(this->*spanFlatTexCutoutZC)(y, x1, x2, w1, w2, u1, u2, v1, v2);
+}
+
+inline void LeRasterizer::fillHalfSpaceTexZC()
+{
+	(this->*blockHalfSpaceTexZC)();
+}
+
+inline void LeRasterizer::fillFlatColor(int y, float x1, float x2, float w1, float w2)
+{
+	(this->*spanFlatColor)(y, x1, x2, w1, w2);
+}
+#elif LE_USE_SIMD == 1 && LE_USE_SSE2 == 1 && LE_USE_AVX2 == 1
+static const LE_RASTERIZER_BACKENDS builtBackend = LE_RASTERIZER_BACKEND_AVX2;
+#elif LE_USE_SIMD == 1 && LE_USE_SSE2 == 1
+static const LE_RASTERIZER_BACKENDS builtBackend = LE_RASTERIZER_BACKEND_SSE2;
+#elif LE_USE_SIMD == 1 && LE_USE_AMMX == 1
+static const LE_RASTERIZER_BACKENDS builtBackend = LE_RASTERIZER_BACKEND_AMMX;
+#else
+static const LE_RASTERIZER_BACKENDS builtBackend = LE_RASTERIZER_BACKEND_REF;
 #endif
 
+/*****************************************************************************/
+/** Automatic filling mode: maximum triangle width and mean span length for edge functions */
+static const float halfSpaceWidth = 64.0f;
+static const float halfSpaceSpan = 16.0f;
+
+/*****************************************************************************/
+/** Automatic perspective mode: maximum estimated affine texture error (in texels) */
+static const float affineError = 1.0f;
+/** Subspan length of affine triangles (longer than any span) */
+static const int affineLength = 0x10000;
+
 /*****************************************************************************/
 LeRasterizer::LeRasterizer(int width, int height) :
 	frame(),
 	background(LeColor()),
+	depth(NULL),
+	visibility(NULL), visBase(1), visNext(1),
+	spanHeads(NULL), spans(NULL),
+	noSpans(0), noSpansAllocated(0),
+	writes(NULL), curSpans(0),
 	texDiffusePixels(NULL),
 	texSizeU(0), texSizeV(0),
 	texMaskU(0), texMaskV(0),
-	curTriangle(NULL), curTrilist(NULL)
+	texTileU(0), texTileV(0),
+	texTileMaskU(0), texTileMaskV(0),
+	curTriangle(NULL), curFlags(0), curTrilist(NULL), visPass(0),
+	fillMode(LE_RASTERIZER_FILL_SCANLINE),
+	scissorX1(0), scissorY1(0),
+	scissorX2(0), scissorY2(0),
+	pool(), workers(NULL), noThreads(0),
+	perspectiveMode(LE_RASTERIZER_PERSPECTIVE_PIXEL), perspectiveSpan(16), subLength(0),
+	backend(LE_RASTERIZER_BACKEND_AUTO),
+	noTilesX(0), noTilesY(0),
+	tileStarts(NULL), tileCursors(NULL),
+	tileIndices(NULL), noTileIndices(0),
+	binOrder(NULL), binRects(NULL), noBinAllocated(0)
 {
 	memset(xs, 0, sizeof(float) * 4);
 	memset(ys, 0, sizeof(float) * 4);
@@ -82,10 +301,95 @@ LeRasterizer::LeRasterizer(int width, int height) :
 	frame.allocate(width, height);
 	frame.clear(background);
 	pixels = (LeColor *) frame.data;
+	scissorX2 = frame.tx;
+	scissorY2 = frame.ty;
+
+// Prepare the fill rate counters
+#if LE_RASTERIZER_STATS == 1
+	writes = new uint32_t[frame.tx * frame.ty];
+#endif // LE_RASTERIZER_STATS
+	resetStats();
+
+// Prepare the screen tiles
+	noTilesX = (frame.tx + LE_RASTERIZER_TILE - 1) / LE_RASTERIZER_TILE;
+	noTilesY = (frame.ty + LE_RASTERIZER_TILE - 1) / LE_RASTERIZER_TILE;
+	tileStarts = new int[noTilesX * noTilesY + 1];
+	tileCursors = new int[noTilesX * noTilesY];
+
+// Select the span fillers
+	setBackend(LE_RASTERIZER_BACKEND_AUTO);
+
+// Start the rasterizer threads
+	setThreads(LE_RASTERIZER_THREADS);
+}
+
+/** Rasterizer of an additional thread (draws tiles of the parent frame) */
+LeRasterizer::LeRasterizer(const LeRasterizer * parent) :
+	frame(),
+	background(LeColor()),
+	depth(NULL),
+	visibility(NULL), visBase(1), visNext(1),
+	spanHeads(NULL), spans(NULL),
+	noSpans(0), noSpansAllocated(0),
+	writes(NULL), curSpans(0),
+	texDiffusePixels(NULL),
+	texSizeU(0), texSizeV(0),
+	texMaskU(0), texMaskV(0),
+	texTileU(0), texTileV(0),
+	texTileMaskU(0), texTileMaskV(0),
+	curTriangle(NULL), curFlags(0), curTrilist(NULL), visPass(0),
+	fillMode(LE_RASTERIZER_FILL_SCANLINE),
+	scissorX1(0), scissorY1(0),
+	scissorX2(0), scissorY2(0),
+	pool(), workers(NULL), noThreads(1),
+	perspectiveMode(parent->perspectiveMode), perspectiveSpan(parent->perspectiveSpan), subLength(0),
+	backend(parent->backend),
+	noTilesX(0), noTilesY(0),
+	tileStarts(NULL), tileCursors(NULL),
+	tileIndices(NULL), noTileIndices(0),
+	binOrder(NULL), binRects(NULL), noBinAllocated(0)
+{
+	memset(xs, 0, sizeof(float) * 4);
+	memset(ys, 0, sizeof(float) * 4);
+	memset(ws, 0, sizeof(float) * 4);
+	memset(us, 0, sizeof(float) * 4);
+	memset(vs, 0, sizeof(float) * 4);
+
+	frame.tx = parent->frame.tx;
+	frame.ty = parent->frame.ty;
+	pixels = parent->pixels;
+	memset(&stats, 0, sizeof(LeRasterizerStats));
+
+#if LE_RASTERIZER_DISPATCH == 1
+	spanFlatTexZC = parent->spanFlatTexZC;
+	spanFlatTexZCFog = parent->spanFlatTexZCFog;
+	spanFlatTexAlphaZC = parent->spanFlatTexAlphaZC;
+	spanFlatTexAlphaZCFog = parent->spanFlatTexAlphaZCFog;
+	spanFlatTexZCDepth = parent->spanFlatTexZCDepth;
+	spanFlatTexCutoutZC = parent->spanFlatTexCutoutZC;
+	blockHalfSpaceTexZC = parent->blockHalfSpaceTexZC;
+	spanFlatColor = parent->spanFlatColor;
+#endif // LE_RASTERIZER_DISPATCH
 }
 
 LeRasterizer::~LeRasterizer()
 {
+	pool.stop();
+	if (workers) {
+		for (int j = 0; j < noThreads - 1; j++)
+			delete workers[j];
+		delete[] workers;
+	}
+	if (tileStarts) delete[] tileStarts;
+	if (tileCursors) delete[] tileCursors;
+	if (tileIndices) delete[] tileIndices;
+	if (binOrder) delete[] binOrder;
+	if (binRects) delete[] binRects;
+	if (depth) delete[] depth;
+	if (visibility) delete[] visibility;
+	if (spanHeads) delete[] spanHeads;
+	if (spans) delete[] spans;
+	if (writes) delete[] writes;
 	frame.deallocate();
 }
 
@@ -97,6 +401,300 @@ LeRasterizer::~LeRasterizer()
 void LeRasterizer::flush()
 {
 	frame.clear(background);
+	if (depth) memset(depth, 0, frame.tx * frame.ty * sizeof(float));
+}
+
+/**
+	\fn bool LeRasterizer::swapFrame(LeBitmap * buffer)
+	\brief Exchange the frame buffer memory with another bitmap (frame buffer double buffering)
+	\param[in] buffer bitmap of the frame buffer size
+	\return true if the buffers have been exchanged, false if the sizes differ
+*/
+bool LeRasterizer::swapFrame(LeBitmap * buffer)
+{
+	if (buffer->tx != frame.tx || buffer->ty != frame.ty) return false;
+
+	void * data = buffer->data;
+	bool dataAllocated = buffer->dataAllocated;
+	buffer->data = frame.data;
+	buffer->dataAllocated = frame.dataAllocated;
+	frame.data = data;
+	frame.dataAllocated = dataAllocated;
+	pixels = (LeColor *) frame.data;
+	return true;
+}
+
+/**
+	\fn void LeRasterizer::setDepthBuffer(bool enable)
+	\brief Enable or disable the depth buffer
+	\param[in] enable depth buffer state
+
+	With the depth buffer, opaque triangles are rasterized front to back
+	and hidden pixels are not textured. Alpha blended and cutout triangles
+	are then rasterized back to front (depth tested only).
+	Disabling the depth buffer also disables the visibility buffer,
+	enabling it disables the span buffer.
+*/
+void LeRasterizer::setDepthBuffer(bool enable)
+{
+	if (depth) delete[] depth;
+	depth = NULL;
+	if (!enable) {
+		setVisibilityBuffer(false);
+		return;
+	}
+	setSpanBuffer(false);
+
+	depth = new float[frame.tx * frame.ty];
+	memset(depth, 0, frame.tx * frame.ty * sizeof(float));
+}
+
+/**
+	\fn void LeRasterizer::setVisibilityBuffer(bool enable)
+	\brief Enable or disable the visibility buffer
+	\param[in] enable visibility buffer state
+
+	With the visibility buffer, opaque triangles are first rasterized
+	front to back writing only their index and depth, then rasterized
+	again and textured on the pixels they own: each visible pixel is
+	textured once, whatever the depth complexity.
+	The visibility buffer works with the depth buffer (enabled with it)
+	and always fills with spans. Alpha blended and cutout triangles are
+	rasterized as with the depth buffer alone.
+*/
+void LeRasterizer::setVisibilityBuffer(bool enable)
+{
+	if (visibility) delete[] visibility;
+	visibility = NULL;
+	if (!enable) return;
+
+	visibility = new uint32_t[frame.tx * frame.ty];
+	memset(visibility, 0, frame.tx * frame.ty * sizeof(uint32_t));
+	visNext = 1;
+	if (!depth) setDepthBuffer(true);
+}
+
+/**
+	\fn void LeRasterizer::setSpanBuffer(bool enable)
+	\brief Enable or disable the span buffer
+	\param[in] enable span buffer state
+
+	With the span buffer, opaque triangles are rasterized front to back
+	and clipped against the spans already covered on each scanline: only
+	the uncovered span fragments are filled, without depth buffer memory.
+	Alpha blended and cutout triangles are then rasterized back to front
+	where they are in front of the covered spans. The covered spans are
+	reset for each triangle list. Enabling the span buffer disables the
+	depth buffer.
+*/
+void LeRasterizer::setSpanBuffer(bool enable)
+{
+	if (spanHeads) delete[] spanHeads;
+	if (spans) delete[] spans;
+	spanHeads = NULL;
+	spans = NULL;
+	noSpans = 0;
+	noSpansAllocated = 0;
+	if (!enable) return;
+
+	setDepthBuffer(false);
+	spanHeads = new int[frame.ty];
+	resetSpanBuffer();
+}
+
+/**
+	\fn void LeRasterizer::setThreads(int count)
+	\brief Set the number of rasterizer threads
+	\param[in] count number of threads (including the calling thread, 0 for one per processor)
+
+	With more than one thread, the triangles are binned into screen tiles
+	(keeping their order) and the tiles are rasterized in parallel.
+*/
+void LeRasterizer::setThreads(int count)
+{
+	if (count <= 0) count = LeThreadPool::getNoProcessors();
+	if (count == noThreads) return;
+
+	pool.start(count);
+	if (workers) {
+		for (int j = 0; j < noThreads - 1; j++)
+			delete workers[j];
+		delete[] workers;
+	}
+	workers = NULL;
+	noThreads = pool.getNoThreads();
+
+// Allocate the rasterizers of the additional threads
+	if (noThreads > 1) {
+		workers = new LeRasterizer * [noThreads - 1];
+		for (int j = 0; j < noThreads - 1; j++)
+			workers[j] = new LeRasterizer(this);
+	}
+}
+
+/**
+	\fn int LeRasterizer::getThreads()
+	\brief Get the number of rasterizer threads
+	\return number of threads (including the calling thread)
+*/
+int LeRasterizer::getThreads()
+{
+	return noThreads;
+}
+
+/**
+	\fn void LeRasterizer::setFillMode(LE_RASTERIZER_FILL_MODES mode)
+	\brief Set the triangle filling strategy
+	\param[in] mode filling strategy
+
+	Edge function filling applies to opaque triangles without fog
+	(or depth buffer), the others are always filled with spans.
+*/
+void LeRasterizer::setFillMode(LE_RASTERIZER_FILL_MODES mode)
+{
+	fillMode = mode;
+}
+
+/**
+	\fn bool LeRasterizer::setBackend(LE_RASTERIZER_BACKENDS backend)
+	\brief Select the span filler implementation
+	\param[in] backend filler implementation (or LE_RASTERIZER_BACKEND_AUTO)
+	\return true if the implementation is available (else unchanged)
+
+	With runtime dispatch (LE_RASTERIZER_DISPATCH), the reference, SSE2
+	and AVX2 fillers are all built in and the automatic selection picks
+	the best one supported by the processor, unless the environment
+	variable LE3D_RASTERIZER_BACKEND is set (ref, sse2 or avx2).
+	Every filler family with a SIMD version switches (span, depth,
+	cutout, half-space and flat color fillers); the AVX2 backend uses
+	the SSE2 fillers of the families without an AVX2 version.
+	Otherwise, only the fillers chosen at compile time are available.
+*/
+bool LeRasterizer::setBackend(LE_RASTERIZER_BACKENDS backend)
+{
+#if LE_RASTERIZER_DISPATCH == 1
+	if (backend == LE_RASTERIZER_BACKEND_AUTO) {
+		backend = LeGlobal::hasAVX2() ? LE_RASTERIZER_BACKEND_AVX2 : LE_RASTERIZER_BACKEND_SSE2;
+		const char * name = getenv("LE3D_RASTERIZER_BACKEND");
+		if (name) {
+			if (strcmp(name, "ref") == 0) backend = LE_RASTERIZER_BACKEND_REF;
+			else if (strcmp(name, "sse2") == 0) backend = LE_RASTERIZER_BACKEND_SSE2;
+		}
+	}
+
+	switch (backend) {
+	case LE_RASTERIZER_BACKEND_REF:
+		spanFlatTexZC = &LeRasterizer::fillFlatTexZCRef;
+		spanFlatTexZCFog = &LeRasterizer::fillFlatTexZCFogRef;
+		spanFlatTexAlphaZC = &LeRasterizer::fillFlatTexAlphaZCRef;
+		spanFlatTexAlphaZCFog = &LeRasterizer::fillFlatTexAlphaZCFogRef;
+		spanFlatTexZCDepth = &LeRasterizer::fillFlatTexZCDepthRef;
+		spanFlatTexCutoutZC = &LeRasterizer::fillFlatTexCutoutZCRef;
+		blockHalfSpaceTexZC = &LeRasterizer::fillHalfSpaceTexZCRef;
+		spanFlatColor = &LeRasterizer::fillFlatColorRef;
+		break;
+	case LE_RASTERIZER_BACKEND_SSE2:
+	case LE_RASTERIZER_BACKEND_AVX2:
+		if (backend == LE_RASTERIZER_BACKEND_AVX2 && !LeGlobal::hasAVX2()) return false;
+		spanFlatTexZC = &LeRasterizer::fillFlatTexZCSSE;
+		spanFlatTexZCFog = &LeRasterizer::fillFlatTexZCFogSSE;
+		spanFlatTexAlphaZC = &LeRasterizer::fillFlatTexAlphaZCSSE;
+		spanFlatTexAlphaZCFog = &LeRasterizer::fillFlatTexAlphaZCFogSSE;
+		spanFlatTexZCDepth = &LeRasterizer::fillFlatTexZCDepthSSE;
+		spanFlatTexCutoutZC = &LeRasterizer::fillFlatTexCutoutZCSSE;
+		blockHalfSpaceTexZC = &LeRasterizer::fillHalfSpaceTexZCSSE;
+		spanFlatColor = &LeRasterizer::fillFlatColorSSE;
+		if (backend == LE_RASTERIZER_BACKEND_AVX2) setFillersAVX2();
+		break;
+	default:
+		return false;
+	}
+	this->backend = backend;
+	return true;
+#else
+	if (backend != LE_RASTERIZER_BACKEND_AUTO && backend != builtBackend) return false;
+	this->backend = builtBackend;
+	return true;
+#endif // LE_RASTERIZER_DISPATCH
+}
+
+/**
+	\fn LE_RASTERIZER_BACKENDS LeRasterizer::getBackend()
+	\brief Get the span filler implementation in use
+	\return filler implementation
+*/
+LE_RASTERIZER_BACKENDS LeRasterizer::getBackend()
+{
+	return backend;
+}
+
+/**
+	\fn void LeRasterizer::setPerspective(LE_RASTERIZER_PERSPECTIVE_MODES mode, int span)
+	\brief Set the texture perspective correction strategy
+	\param[in] mode perspective correction strategy
+	\param[in] span pixels between exact corrections (4 to 256, rounded up to a multiple of 4)
+
+	Subdivided correction applies to opaque triangles without fog
+	(or depth buffer) drawn by the reference fillers. The others, and
+	the SIMD fillers (one approximate reciprocal per vector), are always
+	corrected on every pixel.
+	In automatic mode, the affine texture error is estimated per triangle
+	from its depth range and texture extent.
+*/
+void LeRasterizer::setPerspective(LE_RASTERIZER_PERSPECTIVE_MODES mode, int span)
+{
+	perspectiveMode = mode;
+	perspectiveSpan = (cmbound(span, 4, 256) + 3) & ~3;
+}
+
+/**
+	\fn void LeRasterizer::resetStats()
+	\brief Reset the fill rate counters
+
+	The counters (and pixel writes) accumulate over the rasterized
+	triangle lists until reset. They are only maintained by an
+	instrumented build (LE_RASTERIZER_STATS), they stay at zero otherwise.
+*/
+void LeRasterizer::resetStats()
+{
+	memset(&stats, 0, sizeof(LeRasterizerStats));
+	if (writes) memset(writes, 0, frame.tx * frame.ty * sizeof(uint32_t));
+}
+
+/**
+	\fn bool LeRasterizer::getHeatmap(LeBitmap * heatmap, int maxWrites)
+	\brief Draw the pixel writes per frame pixel in a bitmap
+	\param[in] heatmap bitmap to (re)allocate at the frame size
+	\param[in] maxWrites number of writes shown in red (and more)
+	\return true if the heatmap is available (instrumented build)
+
+	Pixels written once are blue, then green, yellow and red as the
+	writes grow up to maxWrites. Pixels never written are black.
+*/
+bool LeRasterizer::getHeatmap(LeBitmap * heatmap, int maxWrites)
+{
+	if (!writes) return false;
+	heatmap->deallocate();
+	heatmap->allocate(frame.tx, frame.ty);
+
+	const uint8_t ramp[5][3] = {
+		{0, 0, 0}, {0, 0, 255}, {0, 255, 0}, {255, 255, 0}, {255, 0, 0}
+	};
+	if (maxWrites < 1) maxWrites = 1;
+
+	LeColor * p = (LeColor *) heatmap->data;
+	for (int i = 0; i < frame.tx * frame.ty; i++) {
+		int n = cmmin((int) writes[i], maxWrites);
+		int r = n * 4 * 256 / maxWrites;
+		int k = cmmin(r >> 8, 3);
+		int f = r - (k << 8);
+		p[i] = LeColor(
+			(ramp[k][0] * (256 - f) + ramp[k + 1][0] * f) >> 8,
+			(ramp[k][1] * (256 - f) + ramp[k + 1][1] * f) >> 8,
+			(ramp[k][2] * (256 - f) + ramp[k + 1][2] * f) >> 8,
+			255);
+	}
+	return true;
 }
 
 /*****************************************************************************/
@@ -117,120 +715,444 @@ void LeRasterizer::rasterList(LeTriList * trilist)
 #endif
 
 	curTrilist = trilist;
+
+// Tag the triangles above those of the previous lists: pixels owned by
+// an earlier list are not textured again (tags cleared when they wrap)
+	if (visibility) {
+		uint32_t size = (uint32_t) trilist->noAllocated;
+		if (visNext > 0xFFFFFFFFu - size) {
+			memset(visibility, 0, frame.tx * frame.ty * sizeof(uint32_t));
+			visNext = 1;
+		}
+		visBase = visNext;
+		visNext += size;
+	}
+
+	if (noThreads > 1) {
+		rasterTiles(trilist);
+		return;
+	}
+
+	if (!depth && !spanHeads) {
+		for (int i = 0; i < trilist->noValid; i++)
+			rasterTriangle(&trilist->triangles[trilist->srcIndices[i]]);
+		return;
+	}
+	if (spanHeads) resetSpanBuffer();
+
+// Opaque triangles front to back (hidden pixels are not textured)
+// With the visibility buffer: triangle indexes first, then texturing of the visible pixels
+	int noPasses = visibility ? 2 : 1;
+	for (int p = 0; p < noPasses; p++) {
+		visPass = visibility ? p + 1 : 0;
+		for (int i = trilist->noValid - 1; i >= 0; i--) {
+			LeTriangle * triangle = &trilist->triangles[trilist->srcIndices[i]];
+			if (triangle->flags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT)) continue;
+			rasterTriangle(triangle);
+		}
+	}
+	visPass = 0;
+
+// Blended and cutout triangles back to front (depth tested only)
 	for (int i = 0; i < trilist->noValid; i++) {
-		curTriangle = &trilist->triangles[trilist->srcIndices[i]];
-
-	// Retrieve the material
-		LeBmpCache::Slot * slot = &bmpCache.cacheSlots[curTriangle->diffuseTexture];
-		LeBitmap * bmp = slot->bitmap;
-		if (slot->flags & LE_BMPCACHE_ANIMATION)
-			bmp = &slot->extras[slot->cursor];
-
-	// Convert position coordinates
-		float ftx = (float) frame.tx;
-		float fty = (float) frame.ty;
-		xs[0] = cmbound(floorf(curTriangle->xs[0] + 0.5f), 0.0f, ftx);
-		xs[1] = cmbound(floorf(curTriangle->xs[1] + 0.5f), 0.0f, ftx);
-		xs[2] = cmbound(floorf(curTriangle->xs[2] + 0.5f), 0.0f, ftx);
-		ys[0] = cmbound(floorf(curTriangle->ys[0] + 0.5f), 0.0f, fty);
-		ys[1] = cmbound(floorf(curTriangle->ys[1] + 0.5f), 0.0f, fty);
-		ys[2] = cmbound(floorf(curTriangle->ys[2] + 0.5f), 0.0f, fty);
-		ws[0] = curTriangle->zs[0];
-		ws[1] = curTriangle->zs[1];
-		ws[2] = curTriangle->zs[2];
-
-	// Sort vertexes vertically
-		int vt = 0, vb = 0, vm1 = 0, vm2 = 3;
-		if (ys[0] < ys[1]) {
-			if (ys[0] < ys[2]) {
-				vt = 0;
-				if (ys[1] < ys[2]) { vm1 = 1; vb = 2; }
-				else { vm1 = 2; vb = 1; }
-			}
-			else {
-				vt = 2;	vm1 = 0; vb = 1;
+		LeTriangle * triangle = &trilist->triangles[trilist->srcIndices[i]];
+		if (triangle->flags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT)) rasterTriangle(triangle);
+	}
+}
+
+/*****************************************************************************/
+void LeRasterizer::rasterTiles(LeTriList * trilist)
+{
+	int noValid = trilist->noValid;
+	if (noValid > noBinAllocated) {
+		if (binOrder) delete[] binOrder;
+		if (binRects) delete[] binRects;
+		noBinAllocated = cmmax(noValid, noBinAllocated * 2);
+		binOrder = new int[noBinAllocated];
+		binRects = new int[noBinAllocated * 4];
+	}
+
+// Rasterization order (same as the single threaded one)
+	int noOrdered = 0;
+	if (!depth && !spanHeads) {
+		for (int i = 0; i < noValid; i++)
+			binOrder[noOrdered++] = trilist->srcIndices[i];
+	}else{
+		for (int i = noValid - 1; i >= 0; i--) {
+			int index = trilist->srcIndices[i];
+			if (!(trilist->triangles[index].flags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT))) binOrder[noOrdered++] = index;
+		}
+		for (int i = 0; i < noValid; i++) {
+			int index = trilist->srcIndices[i];
+			if (trilist->triangles[index].flags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT)) binOrder[noOrdered++] = index;
+		}
+	}
+
+// Count the triangles per tile
+	int noTiles = noTilesX * noTilesY;
+	memset(tileStarts, 0, (noTiles + 1) * sizeof(int));
+	for (int i = 0; i < noOrdered; i++) {
+		int * rect = &binRects[i * 4];
+		if (!getTileRect(&trilist->triangles[binOrder[i]], rect)) continue;
+		for (int ty = rect[1]; ty <= rect[3]; ty++)
+			for (int tx = rect[0]; tx <= rect[2]; tx++)
+				tileStarts[ty * noTilesX + tx + 1]++;
+	}
+	for (int t = 0; t < noTiles; t++)
+		tileStarts[t + 1] += tileStarts[t];
+
+	int noIndices = tileStarts[noTiles];
+	if (noIndices > noTileIndices) {
+		if (tileIndices) delete[] tileIndices;
+		noTileIndices = cmmax(noIndices, noTileIndices * 2);
+		tileIndices = new int[noTileIndices];
+	}
+
+// Fill the tile bins (keep the triangle order)
+	memcpy(tileCursors, tileStarts, noTiles * sizeof(int));
+	for (int i = 0; i < noOrdered; i++) {
+		int * rect = &binRects[i * 4];
+		if (rect[0] > rect[2]) continue;
+		for (int ty = rect[1]; ty <= rect[3]; ty++)
+			for (int tx = rect[0]; tx <= rect[2]; tx++)
+				tileIndices[tileCursors[ty * noTilesX + tx]++] = binOrder[i];
+	}
+
+// Rasterize the tiles (each tile owns its pixels)
+	for (int j = 0; j < noThreads - 1; j++) {
+		if (!spanHeads != !workers[j]->spanHeads) workers[j]->setSpanBuffer(spanHeads != NULL);
+		workers[j]->pixels = pixels;
+		workers[j]->depth = depth;
+		workers[j]->visibility = visibility;
+		workers[j]->visBase = visBase;
+		workers[j]->writes = writes;
+		workers[j]->curTrilist = trilist;
+		workers[j]->perspectiveMode = perspectiveMode;
+		workers[j]->perspectiveSpan = perspectiveSpan;
+		workers[j]->backend = backend;
+#if LE_RASTERIZER_DISPATCH == 1
+		workers[j]->spanFlatTexZC = spanFlatTexZC;
+		workers[j]->spanFlatTexZCFog = spanFlatTexZCFog;
+		workers[j]->spanFlatTexAlphaZC = spanFlatTexAlphaZC;
+		workers[j]->spanFlatTexAlphaZCFog = spanFlatTexAlphaZCFog;
+		workers[j]->spanFlatTexZCDepth = spanFlatTexZCDepth;
+		workers[j]->spanFlatTexCutoutZC = spanFlatTexCutoutZC;
+		workers[j]->blockHalfSpaceTexZC = blockHalfSpaceTexZC;
+		workers[j]->spanFlatColor = spanFlatColor;
+#endif // LE_RASTERIZER_DISPATCH
+		workers[j]->fillMode = fillMode;
+	}
+	pool.run(tileJob, this, noThreads);
+	for (int j = 0; j < noThreads - 1; j++) {
+		workers[j]->depth = NULL;
+		workers[j]->visibility = NULL;
+		workers[j]->writes = NULL;
+
+	// Gather the fill rate counters
+#if LE_RASTERIZER_STATS == 1
+		LeRasterizerStats * counters = &workers[j]->stats;
+		stats.triangles += counters->triangles;
+		stats.rejectedTriangles += counters->rejectedTriangles;
+		stats.spans += counters->spans;
+		stats.rejectedSpans += counters->rejectedSpans;
+		stats.maxSpans = cmmax(stats.maxSpans, counters->maxSpans);
+		stats.pixels += counters->pixels;
+		for (int f = 0; f < LE_RASTERIZER_NO_FILLERS; f++)
+			stats.fillerPixels[f] += counters->fillerPixels[f];
+		memset(counters, 0, sizeof(LeRasterizerStats));
+#endif // LE_RASTERIZER_STATS
+	}
+
+	scissorX1 = 0;
+	scissorY1 = 0;
+	scissorX2 = frame.tx;
+	scissorY2 = frame.ty;
+}
+
+bool LeRasterizer::getTileRect(const LeTriangle * triangle, int rect[4])
+{
+// Pixel bounds (with a pixel margin) clamped to the frame
+	float x1 = cmmin(cmmin(triangle->xs[0], triangle->xs[1]), triangle->xs[2]) - 1.0f;
+	float y1 = cmmin(cmmin(triangle->ys[0], triangle->ys[1]), triangle->ys[2]) - 1.0f;
+	float x2 = cmmax(cmmax(triangle->xs[0], triangle->xs[1]), triangle->xs[2]) + 1.0f;
+	float y2 = cmmax(cmmax(triangle->ys[0], triangle->ys[1]), triangle->ys[2]) + 1.0f;
+	x1 = cmmax(x1, 0.0f);
+	y1 = cmmax(y1, 0.0f);
+	x2 = cmmin(x2, (float) (frame.tx - 1));
+	y2 = cmmin(y2, (float) (frame.ty - 1));
+
+// Empty rectangle for the triangles outside the frame
+	rect[0] = rect[1] = 1;
+	rect[2] = rect[3] = 0;
+	if (x1 > x2 || y1 > y2) return false;
+
+// Convert to tiles
+	rect[0] = (int) x1 / LE_RASTERIZER_TILE;
+	rect[1] = (int) y1 / LE_RASTERIZER_TILE;
+	rect[2] = (int) x2 / LE_RASTERIZER_TILE;
+	rect[3] = (int) y2 / LE_RASTERIZER_TILE;
+	return true;
+}
+
+void LeRasterizer::tileJob(void * data, int index)
+{
+	LeRasterizer * rasterizer = (LeRasterizer *) data;
+	LeRasterizer * worker = index ? rasterizer->workers[index - 1] : rasterizer;
+	LeTriangle * triangles = rasterizer->curTrilist->triangles;
+
+#if defined(__i386__) || defined(_M_IX86) || defined(_X86_) || defined(__x86_64__) || defined(_M_X64)
+#if defined(_WIN32)
+	_controlfp(_MCW_RC, _RC_CHOP);
+	_controlfp(_MCW_DN, _DN_FLUSH);
+#endif
+#endif
+
+// Interleave the tiles between the threads
+	int noTiles = rasterizer->noTilesX * rasterizer->noTilesY;
+	for (int t = index; t < noTiles; t += rasterizer->noThreads) {
+		int b = rasterizer->tileStarts[t];
+		int e = rasterizer->tileStarts[t + 1];
+		if (b == e) continue;
+
+		int tx = t % rasterizer->noTilesX;
+		int ty = t / rasterizer->noTilesX;
+		worker->scissorX1 = tx * LE_RASTERIZER_TILE;
+		worker->scissorY1 = ty * LE_RASTERIZER_TILE;
+		worker->scissorX2 = cmmin(worker->scissorX1 + LE_RASTERIZER_TILE, rasterizer->frame.tx);
+		worker->scissorY2 = cmmin(worker->scissorY1 + LE_RASTERIZER_TILE, rasterizer->frame.ty);
+		if (worker->spanHeads) worker->resetSpanBuffer();
+
+	// Opaque triangles (first in the bin) in two passes with the visibility buffer
+		if (worker->visibility) {
+			int o = b;
+			while (o < e && !(triangles[rasterizer->tileIndices[o]].flags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT))) o++;
+			for (int p = 1; p <= 2; p++) {
+				worker->visPass = p;
+				for (int i = b; i < o; i++)
+					worker->rasterTriangle(&triangles[rasterizer->tileIndices[i]]);
 			}
+			worker->visPass = 0;
+			b = o;
+		}
+
+		for (int i = b; i < e; i++)
+			worker->rasterTriangle(&triangles[rasterizer->tileIndices[i]]);
+	}
+}
+
+/*****************************************************************************/
+void LeRasterizer::rasterTriangle(LeTriangle * triangle)
+{
+	curTriangle = triangle;
+	curFlags = triangle->flags;
+
+// Convert position coordinates (scissored while filling)
+	xs[0] = floorf(curTriangle->xs[0] + 0.5f);
+	xs[1] = floorf(curTriangle->xs[1] + 0.5f);
+	xs[2] = floorf(curTriangle->xs[2] + 0.5f);
+	ys[0] = floorf(curTriangle->ys[0] + 0.5f);
+	ys[1] = floorf(curTriangle->ys[1] + 0.5f);
+	ys[2] = floorf(curTriangle->ys[2] + 0.5f);
+	ws[0] = curTriangle->zs[0];
+	ws[1] = curTriangle->zs[1];
+	ws[2] = curTriangle->zs[2];
+
+// Sort vertexes vertically
+	int vt = 0, vb = 0, vm1 = 0;
+	if (ys[0] < ys[1]) {
+		if (ys[0] < ys[2]) {
+			vt = 0;
+			if (ys[1] < ys[2]) { vm1 = 1; vb = 2; }
+			else { vm1 = 2; vb = 1; }
 		}
 		else {
-			if (ys[1] < ys[2]) {
-				vt = 1;
-				if (ys[0] < ys[2]) { vm1 = 0; vb = 2; }
-				else { vm1 = 2; vb = 0; }
-			}
-			else {
-				vt = 2; vm1 = 1; vb = 0;
-			}
+			vt = 2;	vm1 = 0; vb = 1;
 		}
+	}
+	else {
+		if (ys[1] < ys[2]) {
+			vt = 1;
+			if (ys[0] < ys[2]) { vm1 = 0; vb = 2; }
+			else { vm1 = 2; vb = 0; }
+		}
+		else {
+			vt = 2; vm1 = 1; vb = 0;
+		}
+	}
 
-	// Get vertical span
-		float dy = ys[vb] - ys[vt];
-		if (dy == 0.0f) continue;
+// Get vertical span
+	float dy = ys[vb] - ys[vt];
+#if LE_RASTERIZER_STATS == 1
+	if (visPass != 2) {
+		if (dy == 0.0f) stats.rejectedTriangles++;
+		else stats.triangles++;
+	}
+	curSpans = 0;
+#endif // LE_RASTERIZER_STATS
+	if (dy == 0.0f) return;
 
-	// Choose the mipmap level
-		if (curTriangle->flags & LE_TRIANGLE_MIPMAPPED) {
-			if (bmp->mmLevels) {
-				float utop = curTriangle->us[vt] / curTriangle->zs[vt];
-				float ubot = curTriangle->us[vb] / curTriangle->zs[vb];
-				float vtop = curTriangle->vs[vt] / curTriangle->zs[vt];
-				float vbot = curTriangle->vs[vb] / curTriangle->zs[vb];
-				float d = cmmax(fabsf(utop - ubot), fabsf(vtop - vbot));
+// Write the triangle index and depth only (no texture setup)
+	if (visPass == 1) {
+		splitTriangle(vt, vm1, vb);
+		return;
+	}
 
-				int r = (int)((d * bmp->ty + dy * 0.5f) / dy);
-				int l = LeGlobal::log2i32(r);
-				l = cmmin(l, bmp->mmLevels - 1);
-				bmp = bmp->mipmaps[l];
-			}
+// Fill untextured triangles with their solid color (no texture setup)
+// Blended and cutout ones keep the textured fillers when depth tested
+	if (!(curTriangle->flags & LE_TRIANGLE_TEXTURED) &&
+		(!depth || visPass || !(curTriangle->flags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT)))) {
+		us[0] = us[1] = us[2] = 0.0f;
+		vs[0] = vs[1] = vs[2] = 0.0f;
+		splitTriangle(vt, vm1, vb);
+		return;
+	}
+
+// Retrieve the material
+	LeBmpCache::Slot * slot = &bmpCache.cacheSlots[curTriangle->diffuseTexture];
+	LeBitmap * bmp = slot->bitmap;
+	if (slot->flags & LE_BMPCACHE_ANIMATION)
+		bmp = &slot->extras[slot->cursor];
+
+// Choose the mipmap level
+	if (curTriangle->flags & LE_TRIANGLE_MIPMAPPED) {
+		if (bmp->mmLevels) {
+			float utop = curTriangle->us[vt] / curTriangle->zs[vt];
+			float ubot = curTriangle->us[vb] / curTriangle->zs[vb];
+			float vtop = curTriangle->vs[vt] / curTriangle->zs[vt];
+			float vbot = curTriangle->vs[vb] / curTriangle->zs[vb];
+			float d = cmmax(fabsf(utop - ubot), fabsf(vtop - vbot));
+
+			int r = (int)((d * bmp->ty + dy * 0.5f) / dy);
+			int l = LeGlobal::log2i32(r);
+			l = cmmin(l, bmp->mmLevels - 1);
+			bmp = bmp->mipmaps[l];
 		}
+	}
+
+// Fill according to the texture level alpha (opaque, cutout or translucent)
+	if (curFlags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT)) {
+		curFlags &= ~(LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT);
+		if (bmp->flags & LE_BITMAP_CUTOUT) curFlags |= LE_TRIANGLE_CUTOUT;
+		else if (bmp->flags & LE_BITMAP_RGBA) curFlags |= LE_TRIANGLE_BLENDED;
+	}
+
+// Retrieve texture information
+	texDiffusePixels = (LeColor *) bmp->data;
+	texSizeU = bmp->txP2;
+	texSizeV = bmp->tyP2;
+	texMaskU = (1 << bmp->txP2) - 1;
+	texMaskV = (1 << bmp->tyP2) - 1;
+
+// Texture layout (a row ordered texture is a single tile wide)
+	if (bmp->flags & LE_BITMAP_TILED) {
+		texTileU = cmmin(bmp->txP2, 2);
+		texTileV = cmmin(bmp->tyP2, 2);
+	}else{
+		texTileU = bmp->txP2;
+		texTileV = 0;
+	}
+	texTileMaskU = (1 << texTileU) - 1;
+	texTileMaskV = (1 << texTileV) - 1;
+
+// Architecture specific pre-calculations
+#if LE_USE_SIMD == 1 && LE_USE_SSE2 == 1
+	float texSizeUFloat = (float) (1 << texSizeU);
+	texScale_4 = _mm_set1_ps(texSizeUFloat);
+#if LE_TEXTURE_TILING == 1
+	texMaskU_4 = _mm_set1_epi32((texMaskU & ~texTileMaskU) << texTileV);
+	texMaskV_4 = _mm_set1_epi32((texMaskV & ~texTileMaskV) << texSizeU);
+	texTileMaskU_4 = _mm_set1_epi32(texTileMaskU);
+	texTileMaskV_4 = _mm_set1_epi32(texTileMaskV << texTileU);
+	texTileShiftU_4 = _mm_cvtsi32_si128(texSizeU - texTileU);
+	texTileShiftV_4 = _mm_cvtsi32_si128(texTileV);
+#else
+	texMaskU_4 = _mm_set1_epi32(texMaskU);
+	texMaskV_4 = _mm_set1_epi32(texMaskV << texSizeU);
+#endif // LE_TEXTURE_TILING
 	
-	// Retrieve texture information
-		texDiffusePixels = (LeColor *) bmp->data;
-		texSizeU = bmp->txP2;
-		texSizeV = bmp->tyP2;
-		texMaskU = (1 << bmp->txP2) - 1;
-		texMaskV = (1 << bmp->tyP2) - 1;
-
-	// Architecture specific pre-calculations
-	#if LE_USE_SIMD == 1 && LE_USE_SSE2 == 1
-		float texSizeUFloat = (float) (1 << texSizeU);
-		texScale_4 = _mm_set1_ps(texSizeUFloat);
-		texMaskU_4 = _mm_set1_epi32(texMaskU);
-		texMaskV_4 = _mm_set1_epi32(texMaskV << texSizeU);
-		
-		__m128i zv = _mm_set1_epi32(0);
-		color_4 = _mm_loadu_si128((__m128i *) &curTriangle->solidColor);
-		color_4 = _mm_unpacklo_epi32(color_4,color_4);
-		color_4 = _mm_unpacklo_epi8(color_4, zv);
-	#elif LE_USE_SIMD == 1 && LE_USE_AMMX == 1
-		prepare_fill_texel(&curTriangle->solidColor);
-	#endif	// LE_USE_SIMD && LE_USE_SSE2
-
-	// Convert texture coordinates
-		float sx = (float) (1 << bmp->txP2);
-		us[0] = curTriangle->us[0] * sx;
-		us[1] = curTriangle->us[1] * sx;
-		us[2] = curTriangle->us[2] * sx;
-
-		float sy = (float) (1 << bmp->tyP2);
-		vs[0] = curTriangle->vs[0] * sy;
-		vs[1] = curTriangle->vs[1] * sy;
-		vs[2] = curTriangle->vs[2] * sy;
-
-	// Compute the mean vertex
-		float n = (ys[vm1] - ys[vt]) / dy;
-		xs[3] = (xs[vb] - xs[vt]) * n + xs[vt];
-		ys[3] = ys[vm1];
-		ws[3] = (ws[vb] - ws[vt]) * n + ws[vt];
-		us[3] = (us[vb] - us[vt]) * n + us[vt];
-		vs[3] = (vs[vb] - vs[vt]) * n + vs[vt];
-
-	// Sort vertexes horizontally
-		int dx = (int) (xs[vm2] - xs[vm1]);
-		if (dx < 0) {int t = vm1; vm1 = vm2; vm2 = t;}
-
-	// Render the triangle
-		fillTriangleZC(vt, vm1, vm2, true);
-		fillTriangleZC(vm1, vm2, vb, false);
+	__m128i zv = _mm_set1_epi32(0);
+	color_4 = _mm_loadu_si128((__m128i *) &curTriangle->solidColor);
+	color_4 = _mm_unpacklo_epi32(color_4,color_4);
+	color_4 = _mm_unpacklo_epi8(color_4, zv);
+#elif LE_USE_SIMD == 1 && LE_USE_AMMX == 1
+	prepare_fill_texel(&curTriangle->solidColor);
+#endif	// LE_USE_SIMD && LE_USE_SSE2
+
+// Convert texture coordinates
+	float sx = (float) (1 << bmp->txP2);
+	us[0] = curTriangle->us[0] * sx;
+	us[1] = curTriangle->us[1] * sx;
+	us[2] = curTriangle->us[2] * sx;
+
+	float sy = (float) (1 << bmp->tyP2);
+	vs[0] = curTriangle->vs[0] * sy;
+	vs[1] = curTriangle->vs[1] * sy;
+	vs[2] = curTriangle->vs[2] * sy;
+
+// Choose the perspective correction (affine for a small depth range)
+// The SIMD fillers share a reciprocal per vector: cheaper than subdividing
+	subLength = 0;
+	if (perspectiveMode != LE_RASTERIZER_PERSPECTIVE_PIXEL && backend == LE_RASTERIZER_BACKEND_REF) {
+		subLength = perspectiveSpan;
+		if (perspectiveMode == LE_RASTERIZER_PERSPECTIVE_AUTO) {
+			const float * zs = curTriangle->zs;
+			float tu0 = curTriangle->us[0] / zs[0];
+			float tu1 = curTriangle->us[1] / zs[1];
+			float tu2 = curTriangle->us[2] / zs[2];
+			float tv0 = curTriangle->vs[0] / zs[0];
+			float tv1 = curTriangle->vs[1] / zs[1];
+			float tv2 = curTriangle->vs[2] / zs[2];
+			float du = (cmmax(cmmax(tu0, tu1), tu2) - cmmin(cmmin(tu0, tu1), tu2)) * (float) (1 << bmp->txP2);
+			float dv = (cmmax(cmmax(tv0, tv1), tv2) - cmmin(cmmin(tv0, tv1), tv2)) * (float) (1 << bmp->tyP2);
+		// Projected w are negative: compare the range to the magnitude
+			float zmin = cmmin(cmmin(zs[0], zs[1]), zs[2]);
+			float zmax = cmmax(cmmax(zs[0], zs[1]), zs[2]);
+			if ((zmax - zmin) * cmmax(du, dv) <= affineError * -(zmax + zmin))
+				subLength = affineLength;
+		}
 	}
+
+// Fill small and thin triangles with edge functions
+	if (fillMode != LE_RASTERIZER_FILL_SCANLINE && !depth && !spanHeads &&
+		!(curFlags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT | LE_TRIANGLE_FOGGED))) {
+		bool halfSpace = fillMode == LE_RASTERIZER_FILL_HALFSPACE;
+		if (!halfSpace) {
+			float x1 = cmmin(cmmin(xs[0], xs[1]), xs[2]);
+			float x2 = cmmax(cmmax(xs[0], xs[1]), xs[2]);
+			float area = fabsf((xs[1] - xs[0]) * (ys[2] - ys[0]) - (xs[2] - xs[0]) * (ys[1] - ys[0]));
+			halfSpace = x2 - x1 <= halfSpaceWidth && area < halfSpaceSpan * 2.0f * dy;
+		}
+		if (halfSpace) {
+#if LE_RASTERIZER_STATS == 1
+			countHalfSpace();
+#endif // LE_RASTERIZER_STATS
+			fillHalfSpaceTexZC();
+			return;
+		}
+	}
+
+	splitTriangle(vt, vm1, vb);
+}
+
+/*****************************************************************************/
+void LeRasterizer::splitTriangle(int vt, int vm1, int vb)
+{
+// Compute the mean vertex
+	int vm2 = 3;
+	float n = (ys[vm1] - ys[vt]) / (ys[vb] - ys[vt]);
+	xs[3] = (xs[vb] - xs[vt]) * n + xs[vt];
+	ys[3] = ys[vm1];
+	ws[3] = (ws[vb] - ws[vt]) * n + ws[vt];
+	us[3] = (us[vb] - us[vt]) * n + us[vt];
+	vs[3] = (vs[vb] - vs[vt]) * n + vs[vt];
+
+// Sort vertexes horizontally
+	int dx = (int) (xs[vm2] - xs[vm1]);
+	if (dx < 0) {int t = vm1; vm1 = vm2; vm2 = t;}
+
+// Render the triangle
+	fillTriangleZC(vt, vm1, vm2, true);
+	fillTriangleZC(vm1, vm2, vb, false);
 }
 
 /*****************************************************************************/
@@ -297,8 +1219,171 @@ void LeRasterizer::fillTriangleZC(int vi1, int vi2, int vi3, bool top)
 		y2 = (int) ys[vi3];
 	}
 
-	if (curTriangle->flags & LE_TRIANGLE_BLENDED) {
-		if (curTriangle->flags & LE_TRIANGLE_FOGGED) {
+// Scissor against the frame (or tile)
+	if (y1 < scissorY1) {
+		float s = (float) (scissorY1 - y1);
+		x1 += ax1 * s; x2 += ax2 * s;
+		u1 += au1 * s; u2 += au2 * s;
+		v1 += av1 * s; v2 += av2 * s;
+		w1 += aw1 * s; w2 += aw2 * s;
+		y1 = scissorY1;
+	}
+	if (y2 > scissorY2) y2 = scissorY2;
+
+#if LE_RASTERIZER_STATS == 1
+	countSpans(y1, y2, x1, x2, ax1, ax2, w1, w2, aw1, aw2);
+#endif // LE_RASTERIZER_STATS
+
+	if (visPass == 1) {
+		for (int y = y1; y < y2; y++) {
+			fillFlatVisibility(y, x1, x2, w1, w2);
+			x1 += ax1; x2 += ax2;
+			w1 += aw1; w2 += aw2;
+		}
+		return;
+	}
+
+	if (visPass == 2) {
+		for (int y = y1; y < y2; y++) {
+			fillVisibleSpan(y, x1, x2, w1, w2, u1, u2, v1, v2);
+			x1 += ax1; x2 += ax2;
+			u1 += au1; u2 += au2;
+			v1 += av1; v2 += av2;
+			w1 += aw1; w2 += aw2;
+		}
+		return;
+	}
+
+	if (spanHeads) {
+		for (int y = y1; y < y2; y++) {
+			fillUncoveredSpan(y, x1, x2, w1, w2, u1, u2, v1, v2);
+			x1 += ax1; x2 += ax2;
+			u1 += au1; u2 += au2;
+			v1 += av1; v2 += av2;
+			w1 += aw1; w2 += aw2;
+		}
+		return;
+	}
+
+	if (depth) {
+		if (!(curFlags & (LE_TRIANGLE_TEXTURED | LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT))) {
+			if (curFlags & LE_TRIANGLE_FOGGED) {
+				for (int y = y1; y < y2; y++) {
+					fillFlatColorFogDepth(y, x1, x2, w1, w2);
+					x1 += ax1; x2 += ax2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+			else {
+				for (int y = y1; y < y2; y++) {
+					fillFlatColorDepth(y, x1, x2, w1, w2);
+					x1 += ax1; x2 += ax2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+			return;
+		}
+		if (curFlags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT)) {
+			if (curFlags & LE_TRIANGLE_FOGGED) {
+				for (int y = y1; y < y2; y++) {
+					fillFlatTexAlphaZCFogDepth(y, x1, x2, w1, w2, u1, u2, v1, v2);
+					x1 += ax1; x2 += ax2;
+					u1 += au1; u2 += au2;
+					v1 += av1; v2 += av2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+			else {
+				for (int y = y1; y < y2; y++) {
+					fillFlatTexAlphaZCDepth(y, x1, x2, w1, w2, u1, u2, v1, v2);
+					x1 += ax1; x2 += ax2;
+					u1 += au1; u2 += au2;
+					v1 += av1; v2 += av2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+		}
+		else {
+			if (curFlags & LE_TRIANGLE_FOGGED) {
+				for (int y = y1; y < y2; y++) {
+					fillFlatTexZCFogDepth(y, x1, x2, w1, w2, u1, u2, v1, v2);
+					x1 += ax1; x2 += ax2;
+					u1 += au1; u2 += au2;
+					v1 += av1; v2 += av2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+			else {
+				for (int y = y1; y < y2; y++) {
+					fillFlatTexZCDepth(y, x1, x2, w1, w2, u1, u2, v1, v2);
+					x1 += ax1; x2 += ax2;
+					u1 += au1; u2 += au2;
+					v1 += av1; v2 += av2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+		}
+		return;
+	}
+
+	if (!(curFlags & LE_TRIANGLE_TEXTURED)) {
+		if (curFlags & LE_TRIANGLE_BLENDED) {
+			if (curFlags & LE_TRIANGLE_FOGGED) {
+				for (int y = y1; y < y2; y++) {
+					fillFlatColorAlphaFog(y, x1, x2, w1, w2);
+					x1 += ax1; x2 += ax2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+			else {
+				for (int y = y1; y < y2; y++) {
+					fillFlatColorAlpha(y, x1, x2, w1, w2);
+					x1 += ax1; x2 += ax2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+		}
+		else {
+			if (curFlags & LE_TRIANGLE_FOGGED) {
+				for (int y = y1; y < y2; y++) {
+					fillFlatColorFog(y, x1, x2, w1, w2);
+					x1 += ax1; x2 += ax2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+			else {
+				for (int y = y1; y < y2; y++) {
+					fillFlatColor(y, x1, x2, w1, w2);
+					x1 += ax1; x2 += ax2;
+					w1 += aw1; w2 += aw2;
+				}
+			}
+		}
+		return;
+	}
+
+	if (curFlags & LE_TRIANGLE_CUTOUT) {
+		if (curFlags & LE_TRIANGLE_FOGGED) {
+			for (int y = y1; y < y2; y++) {
+				fillFlatTexCutoutZCFog(y, x1, x2, w1, w2, u1, u2, v1, v2);
+				x1 += ax1; x2 += ax2;
+				u1 += au1; u2 += au2;
+				v1 += av1; v2 += av2;
+				w1 += aw1; w2 += aw2;
+			}
+		}
+		else {
+			for (int y = y1; y < y2; y++) {
+				fillFlatTexCutoutZC(y, x1, x2, w1, w2, u1, u2, v1, v2);
+				x1 += ax1; x2 += ax2;
+				u1 += au1; u2 += au2;
+				v1 += av1; v2 += av2;
+				w1 += aw1; w2 += aw2;
+			}
+		}
+	}
+	else if (curFlags & LE_TRIANGLE_BLENDED) {
+		if (curFlags & LE_TRIANGLE_FOGGED) {
 			for (int y = y1; y < y2; y++) {
 				fillFlatTexAlphaZCFog(y, x1, x2, w1, w2, u1, u2, v1, v2);
 				x1 += ax1; x2 += ax2;
@@ -318,7 +1403,7 @@ void LeRasterizer::fillTriangleZC(int vi1, int vi2, int vi3, bool top)
 		}
 	}
 	else {
-		if (curTriangle->flags & LE_TRIANGLE_FOGGED) {
+		if (curFlags & LE_TRIANGLE_FOGGED) {
 			for (int y = y1; y < y2; y++) {
 				fillFlatTexZCFog(y, x1, x2, w1, w2, u1, u2, v1, v2);
 				x1 += ax1; x2 += ax2;
@@ -327,6 +1412,15 @@ void LeRasterizer::fillTriangleZC(int vi1, int vi2, int vi3, bool top)
 				w1 += aw1; w2 += aw2;
 			}
 		}
+		else if (subLength) {
+			for (int y = y1; y < y2; y++) {
+				fillFlatTexSubZC(y, x1, x2, w1, w2, u1, u2, v1, v2);
+				x1 += ax1; x2 += ax2;
+				u1 += au1; u2 += au2;
+				v1 += av1; v2 += av2;
+				w1 += aw1; w2 += aw2;
+			}
+		}
 		else {
 			for (int y = y1; y < y2; y++) {
 				fillFlatTexZC(y, x1, x2, w1, w2, u1, u2, v1, v2);
@@ -339,4 +1433,289 @@ void LeRasterizer::fillTriangleZC(int vi1, int vi2, int vi3, bool top)
 	}
 }
 
+/*****************************************************************************/
+void LeRasterizer::fillVisibleSpan(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	if (x1 == x2) return;
+	int xb = cmmax((int) (x1), scissorX1);
+	int xe = cmmin((int) (x2 + 0.9999f), scissorX2);
+	uint32_t index = visBase + (uint32_t) (curTriangle - curTrilist->triangles);
+	const uint32_t * vb = y * frame.tx + visibility;
+
+// Fill the runs of pixels owned by the triangle
+	int x = xb;
+	while (x < xe) {
+		while (x < xe && vb[x] != index) x++;
+		if (x == xe) break;
+		int xr = x + 1;
+		while (xr < xe && vb[xr] == index) xr++;
+		fillSpanRun(x, xr, y, x1, x2, w1, w2, u1, u2, v1, v2);
+		x = xr;
+	}
+}
+
+/*****************************************************************************/
+void LeRasterizer::fillUncoveredSpan(int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+	float d = x2 - x1;
+	if (d == 0.0f) return;
+	float aw = (w2 - w1) / d;
+
+	int xo = (int) (x1);
+	int xb = cmmax(xo, scissorX1);
+	int xe = cmmin((int) (x2 + 0.9999f), scissorX2);
+	bool opaque = !(curFlags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT));
+
+// Walk the covered spans of the scanline (sorted and disjoint)
+	int prev = -1;
+	int s = spanHeads[y];
+	int x = xb;
+	while (x < xe) {
+		int cx1 = s < 0 ? xe : spans[s].x1;
+		int cx2 = s < 0 ? xe : spans[s].x2;
+		if (cx2 <= x) {
+			prev = s;
+			s = spans[s].next;
+			continue;
+		}
+
+	// Uncovered pixels: fill (and cover with opaque triangles)
+		if (x < cx1) {
+			int xr = cmmin(cx1, xe);
+			fillSpanRun(x, xr, y, x1, x2, w1, w2, u1, u2, v1, v2);
+			if (opaque) prev = insertCoveredSpan(y, prev, s, x, xr, w1 + aw * (x - xo), aw);
+			x = xr;
+			continue;
+		}
+
+	// Covered pixels: fill only the blended and cutout pixels in front
+		int xr = cmmin(cx2, xe);
+		if (!opaque) {
+			float ac = spans[s].aw;
+			float wc = spans[s].w + ac * (x - cx1);
+			float wt = w1 + aw * (x - xo);
+			while (x < xr) {
+				while (x < xr && !(wt < wc)) {x++; wt += aw; wc += ac;}
+				int xv = x;
+				while (x < xr && wt < wc) {x++; wt += aw; wc += ac;}
+				if (xv < x) fillSpanRun(xv, x, y, x1, x2, w1, w2, u1, u2, v1, v2);
+			}
+		}
+		x = xr;
+		prev = s;
+		s = spans[s].next;
+	}
+}
+
+/*****************************************************************************/
+void LeRasterizer::fillSpanRun(int xb, int xe, int y, float x1, float x2, float w1, float w2, float u1, float u2, float v1, float v2)
+{
+// Fill the whole span scissored to the run (same interpolants)
+	int sx1 = scissorX1;
+	int sx2 = scissorX2;
+	scissorX1 = xb;
+	scissorX2 = xe;
+#if LE_RASTERIZER_STATS == 1
+	countPixels(y, xb, xe, getFiller());
+#endif // LE_RASTERIZER_STATS
+
+	if (!(curFlags & LE_TRIANGLE_TEXTURED)) {
+		if (curFlags & LE_TRIANGLE_BLENDED) {
+			if (curFlags & LE_TRIANGLE_FOGGED) fillFlatColorAlphaFog(y, x1, x2, w1, w2);
+			else fillFlatColorAlpha(y, x1, x2, w1, w2);
+		}
+		else {
+			if (curFlags & LE_TRIANGLE_FOGGED) fillFlatColorFog(y, x1, x2, w1, w2);
+			else fillFlatColor(y, x1, x2, w1, w2);
+		}
+	}
+	else if (curFlags & LE_TRIANGLE_CUTOUT) {
+		if (curFlags & LE_TRIANGLE_FOGGED) fillFlatTexCutoutZCFog(y, x1, x2, w1, w2, u1, u2, v1, v2);
+		else fillFlatTexCutoutZC(y, x1, x2, w1, w2, u1, u2, v1, v2);
+	}
+	else if (curFlags & LE_TRIANGLE_BLENDED) {
+		if (curFlags & LE_TRIANGLE_FOGGED) fillFlatTexAlphaZCFog(y, x1, x2, w1, w2, u1, u2, v1, v2);
+		else fillFlatTexAlphaZC(y, x1, x2, w1, w2, u1, u2, v1, v2);
+	}
+	else if (curFlags & LE_TRIANGLE_FOGGED) fillFlatTexZCFog(y, x1, x2, w1, w2, u1, u2, v1, v2);
+	else if (subLength) fillFlatTexSubZC(y, x1, x2, w1, w2, u1, u2, v1, v2);
+	else fillFlatTexZC(y, x1, x2, w1, w2, u1, u2, v1, v2);
+
+	scissorX1 = sx1;
+	scissorX2 = sx2;
+}
+
+/*****************************************************************************/
+int LeRasterizer::insertCoveredSpan(int y, int prev, int next, int x1, int x2, float w, float aw)
+{
+	if (noSpans == noSpansAllocated) {
+		int noAllocated = cmmax(1024, noSpansAllocated * 2);
+		CoveredSpan * allocated = new CoveredSpan[noAllocated];
+		if (spans) {
+			memcpy(allocated, spans, noSpans * sizeof(CoveredSpan));
+			delete[] spans;
+		}
+		spans = allocated;
+		noSpansAllocated = noAllocated;
+	}
+
+	CoveredSpan * span = &spans[noSpans];
+	span->x1 = x1;
+	span->x2 = x2;
+	span->w = w;
+	span->aw = aw;
+	span->next = next;
+	if (prev < 0) spanHeads[y] = noSpans;
+	else spans[prev].next = noSpans;
+	return noSpans++;
+}
+
+/*****************************************************************************/
+void LeRasterizer::resetSpanBuffer()
+{
+// Clear the scanlines of the frame (or tile)
+	for (int y = scissorY1; y < scissorY2; y++)
+		spanHeads[y] = -1;
+	noSpans = 0;
+}
+
+#if LE_RASTERIZER_STATS == 1
+/*****************************************************************************/
+int LeRasterizer::getFiller()
+{
+// Same choice as the triangle and span filling
+	if (visPass == 1) return LE_RASTERIZER_FILLER_VISIBILITY;
+	if (depth && !visPass) {
+		if (!(curFlags & (LE_TRIANGLE_TEXTURED | LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT))) {
+			if (curFlags & LE_TRIANGLE_FOGGED) return LE_RASTERIZER_FILLER_COLOR_FOG_DEPTH;
+			return LE_RASTERIZER_FILLER_COLOR_DEPTH;
+		}
+		if (curFlags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT)) {
+			if (curFlags & LE_TRIANGLE_FOGGED) return LE_RASTERIZER_FILLER_TEX_ALPHA_FOG_DEPTH;
+			return LE_RASTERIZER_FILLER_TEX_ALPHA_DEPTH;
+		}
+		if (curFlags & LE_TRIANGLE_FOGGED) return LE_RASTERIZER_FILLER_TEX_FOG_DEPTH;
+		return LE_RASTERIZER_FILLER_TEX_DEPTH;
+	}
+	if (!(curFlags & LE_TRIANGLE_TEXTURED)) {
+		if (curFlags & LE_TRIANGLE_BLENDED) {
+			if (curFlags & LE_TRIANGLE_FOGGED) return LE_RASTERIZER_FILLER_COLOR_ALPHA_FOG;
+			return LE_RASTERIZER_FILLER_COLOR_ALPHA;
+		}
+		if (curFlags & LE_TRIANGLE_FOGGED) return LE_RASTERIZER_FILLER_COLOR_FOG;
+		return LE_RASTERIZER_FILLER_COLOR;
+	}
+	if (curFlags & LE_TRIANGLE_CUTOUT) {
+		if (curFlags & LE_TRIANGLE_FOGGED) return LE_RASTERIZER_FILLER_TEX_CUTOUT_FOG;
+		return LE_RASTERIZER_FILLER_TEX_CUTOUT;
+	}
+	if (curFlags & LE_TRIANGLE_BLENDED) {
+		if (curFlags & LE_TRIANGLE_FOGGED) return LE_RASTERIZER_FILLER_TEX_ALPHA_FOG;
+		return LE_RASTERIZER_FILLER_TEX_ALPHA;
+	}
+	if (curFlags & LE_TRIANGLE_FOGGED) return LE_RASTERIZER_FILLER_TEX_FOG;
+	if (subLength) return LE_RASTERIZER_FILLER_TEX_SUB;
+	return LE_RASTERIZER_FILLER_TEX;
+}
+
+void LeRasterizer::countSpans(int y1, int y2, float x1, float x2, float ax1, float ax2, float w1, float w2, float aw1, float aw2)
+{
+// Texturing passes filling runs count their pixels with the runs
+	if (visPass == 2) return;
+	int filler = getFiller();
+	bool runs = spanHeads != NULL;
+	bool tested = filler == LE_RASTERIZER_FILLER_VISIBILITY ||
+		(filler >= LE_RASTERIZER_FILLER_TEX_DEPTH && filler <= LE_RASTERIZER_FILLER_COLOR_FOG_DEPTH);
+
+	int spans = 0;
+	for (int y = y1; y < y2; y++) {
+		if (runs) {
+			if (x1 == x2) stats.rejectedSpans++;
+			else spans++;
+		}
+		else {
+			float d = x2 - x1;
+			if (d == 0.0f) {
+				stats.rejectedSpans++;
+			}
+			else {
+				spans++;
+				int xb = (int) (x1);
+				int xe = cmmin((int) (x2 + 0.9999f), scissorX2);
+				if (!tested) {
+					countPixels(y, cmmax(xb, scissorX1), xe, filler);
+				}
+				else {
+				// Count the pixels passing the depth test (as the filler)
+					float aw = (w2 - w1) / d;
+					float w = w1;
+					if (xb < scissorX1) {
+						w += aw * (float) (scissorX1 - xb);
+						xb = scissorX1;
+					}
+					const float * zb = y * frame.tx + depth;
+					for (int x = xb; x < xe; x++) {
+						if (w < zb[x]) countPixels(y, x, x + 1, filler);
+						w += aw;
+					}
+				}
+			}
+		}
+		x1 += ax1; x2 += ax2;
+		w1 += aw1; w2 += aw2;
+	}
+
+	stats.spans += spans;
+	curSpans += spans;
+	stats.maxSpans = cmmax(stats.maxSpans, curSpans);
+}
+
+void LeRasterizer::countPixels(int y, int xb, int xe, int filler)
+{
+	if (xb >= xe) return;
+	stats.pixels += xe - xb;
+	stats.fillerPixels[filler] += xe - xb;
+	uint32_t * p = y * frame.tx + writes;
+	for (int x = xb; x < xe; x++)
+		p[x]++;
+}
+
+void LeRasterizer::countHalfSpace()
+{
+// Same coverage as the half-space filler (pixel centers, top-left rule)
+	int ix[3], iy[3];
+	for (int i = 0; i < 3; i++) {
+		ix[i] = (int) xs[i];
+		iy[i] = (int) ys[i];
+	}
+
+	int64_t area = (int64_t) (ix[1] - ix[0]) * (iy[2] - iy[0]) - (int64_t) (ix[2] - ix[0]) * (iy[1] - iy[0]);
+	if (area == 0) return;
+	if (area < 0) {
+		int t = ix[1]; ix[1] = ix[2]; ix[2] = t;
+		t = iy[1]; iy[1] = iy[2]; iy[2] = t;
+	}
+
+	int bx1 = cmmax(cmmin(cmmin(ix[0], ix[1]), ix[2]), scissorX1);
+	int by1 = cmmax(cmmin(cmmin(iy[0], iy[1]), iy[2]), scissorY1);
+	int bx2 = cmmin(cmmax(cmmax(ix[0], ix[1]), ix[2]), scissorX2);
+	int by2 = cmmin(cmmax(cmmax(iy[0], iy[1]), iy[2]), scissorY2);
+
+	for (int y = by1; y < by2; y++) {
+		for (int x = bx1; x < bx2; x++) {
+			bool inside = true;
+			for (int k = 0; k < 3 && inside; k++) {
+				int a = k;
+				int b = k == 2 ? 0 : k + 1;
+				int64_t dx = ix[b] - ix[a];
+				int64_t dy = iy[b] - iy[a];
+				int bias = (dy < 0 || (dy == 0 && dx > 0)) ? 0 : -1;
+				inside = dx * (2 * (y - iy[a]) + 1) - dy * (2 * (x - ix[a]) + 1) + bias >= 0;
+			}
+			if (inside) countPixels(y, x, x + 1, LE_RASTERIZER_FILLER_HALFSPACE);
+		}
+	}
+}
+#endif // LE_RASTERIZER_STATS
+
 #endif // LE_RENDERER_INTRASTER == 0
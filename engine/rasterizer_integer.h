@@ -41,9 +41,86 @@
 #include "draw.h"
 #include "geometry.h"
 #include "trilist.h"
+#include "threads.h"
 #include "simd.h"
 
 /*****************************************************************************/
+/**
+	\enum LE_RASTERIZER_FILL_MODES
+	\brief Triangle filling strategies
+
+	Only the floating point rasterizer has edge function fillers:
+	the fixed point rasterizer accepts these modes but fills spans.
+*/
+typedef enum {
+	LE_RASTERIZER_FILL_SCANLINE = 0,	/**< fill triangles with horizontal spans (default) */
+	LE_RASTERIZER_FILL_HALFSPACE,		/**< fill opaque triangles with edge functions on 4x4 pixel blocks */
+	LE_RASTERIZER_FILL_AUTO,			/**< fill small and thin opaque triangles with edge functions, others with spans */
+} LE_RASTERIZER_FILL_MODES;
+
+/**
+	\enum LE_RASTERIZER_BACKENDS
+	\brief Span filler implementations
+*/
+typedef enum {
+	LE_RASTERIZER_BACKEND_AUTO = 0,		/**< best implementation available (default) */
+	LE_RASTERIZER_BACKEND_REF,			/**< portable C++ fillers */
+	LE_RASTERIZER_BACKEND_SSE2,			/**< Intel SSE2 fillers */
+	LE_RASTERIZER_BACKEND_AVX2,			/**< Intel AVX2 fillers */
+	LE_RASTERIZER_BACKEND_AMMX,			/**< Apollo AMMX fillers */
+} LE_RASTERIZER_BACKENDS;
+
+/**
+	\enum LE_RASTERIZER_PERSPECTIVE_MODES
+	\brief Texture perspective correction strategies
+*/
+typedef enum {
+	LE_RASTERIZER_PERSPECTIVE_PIXEL = 0,	/**< exact perspective correction on every pixel (default) */
+	LE_RASTERIZER_PERSPECTIVE_SPAN,			/**< exact perspective correction every few pixels, affine in between */
+	LE_RASTERIZER_PERSPECTIVE_AUTO,			/**< as span, but affine for triangles with a small depth range */
+} LE_RASTERIZER_PERSPECTIVE_MODES;
+
+/**
+	\enum LE_RASTERIZER_FILLERS
+	\brief Span filler variants (fill rate counters)
+*/
+typedef enum {
+	LE_RASTERIZER_FILLER_TEX = 0,				/**< textured */
+	LE_RASTERIZER_FILLER_TEX_SUB,				/**< textured (subdivided perspective) */
+	LE_RASTERIZER_FILLER_TEX_FOG,				/**< textured and fogged */
+	LE_RASTERIZER_FILLER_TEX_ALPHA,				/**< textured and alpha blended */
+	LE_RASTERIZER_FILLER_TEX_ALPHA_FOG,			/**< textured, alpha blended and fogged */
+	LE_RASTERIZER_FILLER_TEX_CUTOUT,			/**< textured and alpha tested */
+	LE_RASTERIZER_FILLER_TEX_CUTOUT_FOG,		/**< textured, alpha tested and fogged */
+	LE_RASTERIZER_FILLER_TEX_DEPTH,				/**< textured (depth tested) */
+	LE_RASTERIZER_FILLER_TEX_FOG_DEPTH,			/**< textured and fogged (depth tested) */
+	LE_RASTERIZER_FILLER_TEX_ALPHA_DEPTH,		/**< textured and alpha blended (depth tested) */
+	LE_RASTERIZER_FILLER_TEX_ALPHA_FOG_DEPTH,	/**< textured, alpha blended and fogged (depth tested) */
+	LE_RASTERIZER_FILLER_COLOR_DEPTH,			/**< solid color (depth tested) */
+	LE_RASTERIZER_FILLER_COLOR_FOG_DEPTH,		/**< solid color and fogged (depth tested) */
+	LE_RASTERIZER_FILLER_COLOR,					/**< solid color */
+	LE_RASTERIZER_FILLER_COLOR_FOG,				/**< solid color and fogged */
+	LE_RASTERIZER_FILLER_COLOR_ALPHA,			/**< solid color and alpha blended */
+	LE_RASTERIZER_FILLER_COLOR_ALPHA_FOG,		/**< solid color, alpha blended and fogged */
+	LE_RASTERIZER_FILLER_VISIBILITY,			/**< triangle index and depth (depth tested) */
+	LE_RASTERIZER_FILLER_HALFSPACE,				/**< textured with edge functions */
+	LE_RASTERIZER_NO_FILLERS,					/**< number of filler variants */
+} LE_RASTERIZER_FILLERS;
+
+/**
+	\struct LeRasterizerStats
+	\brief Fill rate counters (instrumented build, see LE_RASTERIZER_STATS)
+*/
+typedef struct {
+	int64_t triangles;							/**< rasterized triangles */
+	int64_t rejectedTriangles;					/**< triangles without height (dy == 0) */
+	int64_t spans;								/**< filled spans */
+	int64_t rejectedSpans;						/**< spans without width (d == 0) */
+	int maxSpans;								/**< most spans filled for a single triangle */
+	int64_t pixels;								/**< pixel writes */
+	int64_t fillerPixels[LE_RASTERIZER_NO_FILLERS];	/**< pixel writes per filler variant */
+} LeRasterizerStats;
+
 /**
 	\class LeRasterizer
 	\brief Rasterize triangle lists
@@ -57,26 +134,161 @@ public:
 	void rasterList(LeTriList * trilist);
 	const void * getPixels() {return pixels;}
 	void flush();
+	bool swapFrame(LeBitmap * buffer);
+
+	void setDepthBuffer(bool enable);
+	void setVisibilityBuffer(bool enable);
+	void setSpanBuffer(bool enable);
+	void setThreads(int count);
+	int getThreads();
+	void setFillMode(LE_RASTERIZER_FILL_MODES mode);
+	bool setBackend(LE_RASTERIZER_BACKENDS backend);
+	LE_RASTERIZER_BACKENDS getBackend();
+	void setPerspective(LE_RASTERIZER_PERSPECTIVE_MODES mode, int span = 16);
+
+	void resetStats();
+	const LeRasterizerStats * getStats() {return &stats;}
+	bool getHeatmap(LeBitmap * heatmap, int maxWrites = 4);
 
 	LeBitmap frame;					/**< frame buffer */ 
 	LeColor background;				/**< background color */ 
 	
 private:
+	LeRasterizer(const LeRasterizer * parent);
+
+	void rasterTiles(LeTriList * trilist);
+	bool getTileRect(const LeTriangle * triangle, int rect[4]);
+	static void tileJob(void * data, int index);
+
+	inline void rasterTriangle(LeTriangle * triangle);
+	inline void splitTriangle(int vt, int vm1, int vb);
 	inline void fillTriangleZC(int vi1, int vi2, int vi3, bool top);
+	inline void fillVisibleSpan(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillUncoveredSpan(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillSpanRun(int xb, int xe, int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline int insertCoveredSpan(int y, int prev, int next, int x1, int x2, int w, int aw);
+	inline void resetSpanBuffer();
+#if LE_RASTERIZER_STATS == 1
+	inline int getFiller();
+	inline void countSpans(int y1, int y2, int x1, int x2, int ax1, int ax2, int w1, int w2, int aw1, int aw2);
+	inline void countPixels(int y, int xb, int xe, int filler);
+#endif // LE_RASTERIZER_STATS
+	inline uint32_t texelIndex(uint32_t tu, uint32_t tv);
 	inline void fillFlatTexZC(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexSubZC(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
 	inline void fillFlatTexZCFog(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
 	inline void fillFlatTexAlphaZC(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
 	inline void fillFlatTexAlphaZCFog(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexCutoutZC(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexCutoutZCFog(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexZCDepth(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexZCFogDepth(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexAlphaZCDepth(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexAlphaZCFogDepth(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatColor(int y, int x1, int x2, int w1, int w2);
+	inline void fillFlatColorFog(int y, int x1, int x2, int w1, int w2);
+	inline void fillFlatColorAlpha(int y, int x1, int x2, int w1, int w2);
+	inline void fillFlatColorAlphaFog(int y, int x1, int x2, int w1, int w2);
+	inline void fillFlatColorDepth(int y, int x1, int x2, int w1, int w2);
+	inline void fillFlatColorFogDepth(int y, int x1, int x2, int w1, int w2);
+	inline void fillFlatVisibility(int y, int x1, int x2, int w1, int w2);
+
+#if LE_RASTERIZER_DISPATCH == 1
+	typedef void (LeRasterizer::*SpanFiller)(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	typedef void (LeRasterizer::*ColorFiller)(int y, int x1, int x2, int w1, int w2);
+	void setFillersAVX2();
+
+	inline void fillFlatTexZCRef(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexZCFogRef(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexAlphaZCRef(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexAlphaZCFogRef(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexSubZCRef(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatColorRef(int y, int x1, int x2, int w1, int w2);
+
+	inline void fillFlatTexZCSSE(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexZCFogSSE(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexAlphaZCSSE(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexAlphaZCFogSSE(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexSubZCSSE(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatColorSSE(int y, int x1, int x2, int w1, int w2);
+
+	inline void fillFlatTexZCAVX2(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexZCFogAVX2(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexAlphaZCAVX2(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+	inline void fillFlatTexAlphaZCFogAVX2(int y, int x1, int x2, int w1, int w2, int u1, int u2, int v1, int v2);
+#endif // LE_RASTERIZER_DISPATCH
+
+	/**
+		\struct CoveredSpan
+		\brief span buffer covered span (sorted per scanline)
+	**/
+	typedef struct{
+		int x1;						/**< first covered pixel */
+		int x2;						/**< last covered pixel (excluded) */
+		int w;						/**< depth (1 / z) on the first pixel */
+		int aw;						/**< depth increment per pixel */
+		int next;					/**< next covered span of the scanline (-1 for the last) */
+	}CoveredSpan;
 
 	LeColor * pixels;				/**< frame pixel buffer */
+	int32_t * depth;				/**< depth buffer (1 / z, NULL if disabled) */
+	uint32_t * visibility;			/**< visibility buffer (triangle tags, 0 if none, NULL if disabled) */
+	uint32_t visBase;				/**< visibility tag of the first triangle of the current list */
+	uint32_t visNext;				/**< visibility tag of the first triangle of the next list */
+	int * spanHeads;				/**< span buffer first covered span per scanline (NULL if disabled) */
+	CoveredSpan * spans;			/**< span buffer covered spans */
+	int noSpans;					/**< number of used covered spans */
+	int noSpansAllocated;			/**< number of allocated covered spans */
+	LeRasterizerStats stats;		/**< fill rate counters (instrumented build) */
+	uint32_t * writes;				/**< pixel writes per frame pixel (instrumented build) */
+	int curSpans;					/**< spans filled for the current triangle */
 	LeColor * texDiffusePixels;		/**< diffuse texture pixel buffer */
 	uint32_t texSizeU;				/**< textures horizontal size */	
 	uint32_t texSizeV;				/**< textures vertical size */
 	uint32_t texMaskU;				/**< textures horizontal mask */
 	uint32_t texMaskV;				/**< textures vertical mask */
+	uint32_t texTileU;				/**< textures tile horizontal size (tiled layout) */
+	uint32_t texTileV;				/**< textures tile vertical size (tiled layout) */
+	uint32_t texTileMaskU;			/**< textures tile horizontal mask */
+	uint32_t texTileMaskV;			/**< textures tile vertical mask */
 	
 	LeTriangle * curTriangle;		/**< current triangle */
+	int curFlags;					/**< current triangle fill flags (texture level alpha applied) */
 	LeTriList * curTrilist;			/**< current triangle list */
+	int visPass;					/**< visibility buffer pass (0: none, 1: triangle indexes, 2: texturing) */
+
+	int scissorX1;					/**< scissor left bound (frame or tile) */
+	int scissorY1;					/**< scissor top bound (frame or tile) */
+	int scissorX2;					/**< scissor right bound (excluded) */
+	int scissorY2;					/**< scissor bottom bound (excluded) */
+
+	LeThreadPool pool;				/**< rasterizer threads */
+	LeRasterizer ** workers;		/**< rasterizers of the additional threads */
+	int noThreads;					/**< number of rasterizer threads */
+
+	LE_RASTERIZER_PERSPECTIVE_MODES perspectiveMode;	/**< texture perspective correction strategy */
+	int perspectiveSpan;			/**< pixels between exact perspective corrections */
+	int subLength;					/**< current triangle subspan length (0 for per pixel correction) */
+
+	LE_RASTERIZER_BACKENDS backend;	/**< span filler implementation */
+#if LE_RASTERIZER_DISPATCH == 1
+	SpanFiller spanFlatTexZC;			/**< span fillers of the selected implementation */
+	SpanFiller spanFlatTexZCFog;
+	SpanFiller spanFlatTexAlphaZC;
+	SpanFiller spanFlatTexAlphaZCFog;
+	SpanFiller spanFlatTexSubZC;
+	ColorFiller spanFlatColor;
+#endif // LE_RASTERIZER_DISPATCH
+
+	int noTilesX;					/**< number of horizontal tiles */
+	int noTilesY;					/**< number of vertical tiles */
+	int * tileStarts;				/**< bin start per tile (in tileIndices) */
+	int * tileCursors;				/**< bin fill cursor per tile */
+	int * tileIndices;				/**< binned triangle indexes */
+	int noTileIndices;				/**< number of allocated binned triangle indexes */
+	int * binOrder;					/**< triangle indexes in rasterization order */
+	int * binRects;					/**< tile rectangle per ordered triangle */
+	int noBinAllocated;				/**< number of allocated ordered triangles */
 
 #if LE_USE_SIMD == 1 && LE_USE_SSE2 == 1
 	__m128i color_4;
@@ -0,0 +1,73 @@
+/**
+	\file rasterizer_integer_avx2.cpp
+	\brief LightEngine 3D: Triangle rasterizer (fixed point) - AVX2 span fillers
+	\brief Intel x86 CPU (with AVX2) implementation
+	\brief Built with AVX2 code generation and selected at runtime
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frédéric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "global.h"
+#include "config.h"
+
+#if LE_RENDERER_INTRASTER == 1 && LE_RASTERIZER_DISPATCH == 1
+
+#include "rasterizer.h"
+#include "immintrin.h"
+
+/*****************************************************************************/
+/** AVX2 span fillers */
+	#define fillFlatTexZC				fillFlatTexZCAVX2
+	#define fillFlatTexZCFog			fillFlatTexZCFogAVX2
+	#define fillFlatTexAlphaZC			fillFlatTexAlphaZCAVX2
+	#define fillFlatTexAlphaZCFog		fillFlatTexAlphaZCFogAVX2
+	#include "fillers/integer/avx2/flattexzc.h"
+	#include "fillers/integer/avx2/flattexzcfog.h"
+	#include "fillers/integer/avx2/flattexalphazc.h"
+	#include "fillers/integer/avx2/flattexalphazcfog.h"
+	#undef fillFlatTexZC
+	#undef fillFlatTexZCFog
+	#undef fillFlatTexAlphaZC
+	#undef fillFlatTexAlphaZCFog
+
+/*****************************************************************************/
+/**
+	\fn void LeRasterizer::setFillersAVX2()
+	\brief Select the AVX2 span fillers
+
+	The caller checks the processor supports AVX2 & FMA instructions.
+	Families without an AVX2 version keep the SSE2 fillers.
+*/
+void LeRasterizer::setFillersAVX2()
+{
+	spanFlatTexZC = &LeRasterizer::fillFlatTexZCAVX2;
+	spanFlatTexZCFog = &LeRasterizer::fillFlatTexZCFogAVX2;
+	spanFlatTexAlphaZC = &LeRasterizer::fillFlatTexAlphaZCAVX2;
+	spanFlatTexAlphaZCFog = &LeRasterizer::fillFlatTexAlphaZCFogAVX2;
+}
+
+#endif // LE_RENDERER_INTRASTER && LE_RASTERIZER_DISPATCH
@@ -39,24 +39,34 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <float.h>
 
 /*****************************************************************************/
-#if LE_RENDERER_3DFRUSTRUM == 0 && LE_RENDERER_2DFRAME == 0
-	#error One of the clipping systems (3D frustrum or 2D frame) must be enabled (in config.h).
+#if LE_RENDERER_3DFRUSTRUM == 0 && LE_RENDERER_2DFRAME == 0 && LE_RENDERER_GUARDBAND == 0
+	#error One of the clipping systems (3D frustrum, 2D frame or guard band) must be enabled (in config.h).
 #endif
 
 /*****************************************************************************/
 LeRenderer::LeRenderer(int width, int height) :
 	usedVerlist(&intVerlist),
 	usedTrilist(&intTrilist),
-	extra(0), extraMax(0),
-	colors(NULL),
+	pool(),
+	jobs(NULL),
+	threadVerlists(NULL),
+	noThreads(0),
+	instFlags(NULL), noInstFlags(0),
 	viewFov(LE_RENDERER_FOV_DEFAULT),
 	ztx(1.0f), zty(1.0f),
 	vOffset(0.0f),
 	backMode(LE_BACKCULLING_CCW),
+	objectCullingEnable(true),
 	mipmappingEnable(true),
-	fogEnable(false)
+	fogEnable(false),
+	clipMode((LE_RENDERER_3DFRUSTRUM ? LE_CLIPPING_3DFRUSTRUM : 0) |
+			 (LE_RENDERER_2DFRAME ? LE_CLIPPING_2DFRAME : 0) |
+			 (LE_RENDERER_GUARDBAND ? LE_CLIPPING_GUARDBAND : 0)),
+	guardRatio(LE_RENDERER_GUARDBAND_DEFAULT),
+	stats()
 {
 // Configure viewport
 	setViewport(0, 0, width, height);
@@ -66,12 +76,19 @@ LeRenderer::LeRenderer(int width, int height) :
 	setViewPosition(LeVertex(0.0f, 0.0f, 0.0f));
 	setViewAngle(LeVertex(0.0f, 0.0f, 0.0f));
 
+// Start the geometry threads
+	setThreads(LE_RENDERER_THREADS);
+
 // Flush the lists
 	flush();
 }
 
 LeRenderer::~LeRenderer()
 {
+	pool.stop();
+	if (jobs) delete[] jobs;
+	if (threadVerlists) delete[] threadVerlists;
+	if (instFlags) delete[] instFlags;
 }
 
 /*****************************************************************************/
@@ -82,47 +99,183 @@ LeRenderer::~LeRenderer()
 */
 void LeRenderer::render(const LeMesh * mesh)
 {
-// Check vertex memory space
-	if (!checkMemory(mesh->noVertexes, mesh->noTriangles))
+	stats.noMeshes++;
+	renderMesh(mesh, mesh->view);
+}
+
+/**
+	\fn void LeRenderer::render(const LeMeshLOD * lod)
+	\brief Render the level of a mesh LOD chain matching its projected size
+	\param[in] lod pointer to a mesh LOD chain
+*/
+void LeRenderer::render(const LeMeshLOD * lod)
+{
+	stats.noMeshes++;
+	if (!lod->noLevels) return;
+
+// Select the level with the first level bounding sphere
+	const LeMesh * mesh = lod->getLevel(getProjectedRadius(lod->levels[0], lod->view));
+	if (!mesh) {
+		stats.noCulled++;
 		return;
+	}
+	renderMesh(mesh, lod->view);
+}
 
-// Transform the geometry
-	LeTriangle * triRender = &usedTrilist->triangles[usedTrilist->noUsed];
-	int * id1 = &usedTrilist->srcIndices[usedTrilist->noValid];
-	int * id2 = &usedTrilist->dstIndices[usedTrilist->noValid];
+/**
+	\fn void LeRenderer::renderMesh(const LeMesh * mesh, const LeMatrix & matrix)
+	\brief Render a 3D mesh with a view matrix
+	\param[in] mesh pointer to a mesh
+	\param[in] matrix mesh view matrix
+*/
+void LeRenderer::renderMesh(const LeMesh * mesh, const LeMatrix & matrix)
+{
+// Cull against the view frustrum (meshes fully inside skip the outcodes and the clipping)
+	int visibility = checkBounds(mesh, matrix);
+	if (visibility == LE_RENDERER_OUTSIDE) {
+		stats.noCulled++;
+		return;
+	}
+	bool inside = visibility == LE_RENDERER_INSIDE;
 
-	transform(mesh->view, mesh->vertexes, usedVerlist->vertexes, mesh->noVertexes);
-	int noTris = build(mesh, usedVerlist->vertexes, triRender, id1);
-	extra = noTris;
+// Check vertex and triangle memory space
+	reserveLists(1, mesh->noVertexes, mesh->noTriangles);
+	int freeTriangles = usedTrilist->noAllocated - usedTrilist->noUsed;
+	if (mesh->noVertexes > usedVerlist->noAllocated || mesh->noTriangles > freeTriangles) {
+		stats.noDropped++;
+		return;
+	}
 
-// Clip and project
-	noTris = clip3D(triRender, id1, id2, noTris, viewFrontPlan);
-	noTris = clip3D(triRender, id2, id1, noTris, viewBackPlan);
+// Split large meshes across the threads
+	int noJobs = 1;
+	if (mesh->noTriangles >= LE_RENDERER_SPLIT) noJobs = noThreads;
 
-#if LE_RENDERER_3DFRUSTRUM == 1
-	noTris = clip3D(triRender, id1, id2, noTris, viewLeftPlan);
-	noTris = clip3D(triRender, id2, id1, noTris, viewRightPlan);
-	noTris = clip3D(triRender, id1, id2, noTris, viewTopPlan);
-	noTris = clip3D(triRender, id2, id1, noTris, viewBotPlan);
-#endif // LE_RENDERER_3DFRUSTRUM
+	if (noJobs == 1) {
+		transform(mesh, matrix, usedVerlist, 0, mesh->noVertexes, inside);
+		jobs[0].weight = mesh->noTriangles;
+		openSegments(1);
+		renderRange(mesh, matrix, NULL, usedVerlist, 0, mesh->noTriangles, inside, jobs[0].segment);
+		closeSegments(1);
+		return;
+	}
 
-	noTris = project(triRender, id1, id2, noTris);
-	noTris = backculling(triRender, id2, id1, noTris);
+// Transform the vertexes (blocks of 8 vertexes per thread)
+	for (int j = 0; j < noJobs; j++) {
+		int v1 = ((mesh->noVertexes * j) / noJobs) & ~7;
+		int v2 = j == noJobs - 1 ? mesh->noVertexes : ((mesh->noVertexes * (j + 1)) / noJobs) & ~7;
+		jobs[j].meshes = &mesh;
+		jobs[j].matrices = &matrix;
+		jobs[j].first = v1;
+		jobs[j].nb = v2 - v1;
+		jobs[j].inside = inside;
+	}
+	pool.run(vertexJob, this, noJobs);
+
+// Build, clip and project the triangles
+	for (int j = 0; j < noJobs; j++) {
+		int t1 = (mesh->noTriangles * j) / noJobs;
+		int t2 = (mesh->noTriangles * (j + 1)) / noJobs;
+		jobs[j].first = t1;
+		jobs[j].nb = t2 - t1;
+		jobs[j].weight = t2 - t1;
+	}
+	openSegments(noJobs);
+	pool.run(triangleJob, this, noJobs);
+	closeSegments(noJobs);
+}
 
-#if LE_RENDERER_2DFRAME == 1
-	noTris = clip2D(triRender, id1, id2, noTris, viewLeftAxis);
-	noTris = clip2D(triRender, id2, id1, noTris, viewRightAxis);
-	noTris = clip2D(triRender, id1, id2, noTris, viewTopAxis);
-	noTris = clip2D(triRender, id2, id1, noTris, viewBottomAxis);
-#endif // LE_RENDERER_2DFRAME
+/**
+	\fn void LeRenderer::render(const LeMesh * const meshes[], int noMeshes)
+	\brief Render a batch of 3D meshes (shared across the geometry threads)
+	\param[in] meshes array of mesh pointers
+	\param[in] noMeshes number of meshes
+*/
+void LeRenderer::render(const LeMesh * const meshes[], int noMeshes)
+{
+	if (noThreads == 1 || noMeshes < 2) {
+		for (int i = 0; i < noMeshes; i++)
+			render(meshes[i]);
+		return;
+	}
 
-// Make render indices absolute
-	for (int i = 0; i < noTris; i++)
-		id1[i] += usedTrilist->noUsed;
+// Balance the triangles between the threads
+	int total = 0;
+	int noVertexes = 0;
+	for (int i = 0; i < noMeshes; i++) {
+		total += meshes[i]->noTriangles;
+		noVertexes = cmmax(noVertexes, meshes[i]->noVertexes);
+	}
 
-// Modify the state
-	usedTrilist->noUsed += extra;
-	usedTrilist->noValid += noTris;
+	int noJobs = cmmin(noThreads, noMeshes);
+	reserveLists(noJobs, noVertexes, total);
+	int m = 0;
+	int sum = 0;
+	for (int j = 0; j < noJobs; j++) {
+		int target = (int) (((int64_t) total * (j + 1)) / noJobs);
+		jobs[j].meshes = meshes;
+		jobs[j].first = m;
+		jobs[j].weight = 0;
+		int left = noJobs - j - 1;
+		while (m < noMeshes - left && (sum < target || m == jobs[j].first || j == noJobs - 1)) {
+			jobs[j].weight += meshes[m]->noTriangles;
+			sum += meshes[m++]->noTriangles;
+		}
+		jobs[j].nb = m - jobs[j].first;
+	}
+
+	openSegments(noJobs);
+	pool.run(batchJob, this, noJobs);
+	closeSegments(noJobs);
+}
+
+/**
+	\fn void LeRenderer::renderInstances(const LeMesh * mesh, const LeMatrix matrices[], int count)
+	\brief Render many instances of a 3D mesh (shared across the geometry threads)
+	\param[in] mesh pointer to a mesh
+	\param[in] matrices view matrix of each instance
+	\param[in] count number of instances
+*/
+void LeRenderer::renderInstances(const LeMesh * mesh, const LeMatrix matrices[], int count)
+{
+	if (count <= 0) return;
+
+// Compute the triangle flags once for all the instances
+	if (mesh->noTriangles > noInstFlags) {
+		if (instFlags) delete[] instFlags;
+		instFlags = new int[mesh->noTriangles];
+		noInstFlags = mesh->noTriangles;
+	}
+
+	int flags = LE_TRIANGLE_TEXTURED;
+	if (mipmappingEnable) flags |= LE_TRIANGLE_MIPMAPPED;
+	if (fogEnable) flags |= LE_TRIANGLE_FOGGED;
+
+	for (int i = 0; i < mesh->noTriangles; i++) {
+		instFlags[i] = flags;
+		if (!mesh->texSlotList[i])
+			instFlags[i] &= ~LE_TRIANGLE_TEXTURED;
+		else if (bmpCache.cacheSlots[mesh->texSlotList[i]].flags & LE_BMPCACHE_CUTOUT)
+			instFlags[i] |= LE_TRIANGLE_CUTOUT;
+		else if (bmpCache.cacheSlots[mesh->texSlotList[i]].flags & LE_BMPCACHE_RGBA)
+			instFlags[i] |= LE_TRIANGLE_BLENDED;
+	}
+
+// Share the instances between the threads
+	int noJobs = cmmin(noThreads, count);
+	reserveLists(noJobs, mesh->noVertexes, (int) cmmin((int64_t) count * mesh->noTriangles, (int64_t) LE_TRILIST_MAX));
+	for (int j = 0; j < noJobs; j++) {
+		int i1 = (count * j) / noJobs;
+		int i2 = (count * (j + 1)) / noJobs;
+		jobs[j].meshes = &mesh;
+		jobs[j].matrices = matrices;
+		jobs[j].first = i1;
+		jobs[j].nb = i2 - i1;
+		jobs[j].weight = (i2 - i1) * mesh->noTriangles;
+	}
+
+	openSegments(noJobs);
+	pool.run(instanceJob, this, noJobs);
+	closeSegments(noJobs);
 }
 
 /**
@@ -135,46 +288,270 @@ void LeRenderer::render(const LeBSet * bset)
 // Check vertex memory space
 	int noVertexes = bset->noBillboards * 4;
 	int noTriangles = bset->noBillboards * 2;
-	if (!checkMemory(noVertexes, noTriangles))
+	reserveLists(1, noVertexes, noTriangles);
+	int freeTriangles = usedTrilist->noAllocated - usedTrilist->noUsed;
+	if (noVertexes > usedVerlist->noAllocated || noTriangles > freeTriangles) {
+		stats.noDropped++;
 		return;
+	}
+
+	jobs[0].weight = noTriangles;
+	openSegments(1);
+	Segment & segment = jobs[0].segment;
 
 // Transform the geometry
-	LeTriangle * triRender = &usedTrilist->triangles[usedTrilist->noUsed];
-	int * id1 = &usedTrilist->srcIndices[usedTrilist->noValid];
-	int * id2 = &usedTrilist->dstIndices[usedTrilist->noValid];
+	LeTriangle * triRender = segment.tris;
+	int * id1 = segment.srcIndices;
+	int * id2 = segment.dstIndices;
 
 	transform(bset->view, bset->places, usedVerlist->vertexes, bset->noBillboards);
 	int noTris = build(bset, usedVerlist->vertexes, triRender, id1);
-	extra = noTris;
+	segment.extra = noTris;
+	segment.extraMax = segment.noAllocated;
 
 // Clip and project
-	noTris = clip3D(triRender, id1, id2, noTris, viewFrontPlan);
-	noTris = clip3D(triRender, id2, id1, noTris, viewBackPlan);
-
-#if LE_RENDERER_3DFRUSTRUM == 1
-	noTris = clip3D(triRender, id1, id2, noTris, viewLeftPlan);
-	noTris = clip3D(triRender, id2, id1, noTris, viewRightPlan);
-	noTris = clip3D(triRender, id1, id2, noTris, viewTopPlan);
-	noTris = clip3D(triRender, id2, id1, noTris, viewBotPlan);
-#endif // LE_RENDERER_3DFRUSTRUM
+	int * src = id1;
+	int * dst = id2;
+	for (int p = 0; p < noClipPlanes; p++) {
+		noTris = clip3D(triRender, src, dst, noTris, *clipPlanes[p], 1 << p, segment);
+		int * tmp = src;
+		src = dst;
+		dst = tmp;
+	}
 
-	noTris = project(triRender, id1, id2, noTris);
+	noTris = project(triRender, src, id2, noTris);
 	noTris = backculling(triRender, id2, id1, noTris);
 
-#if LE_RENDERER_2DFRAME == 1
-	noTris = clip2D(triRender, id1, id2, noTris, viewLeftAxis);
-	noTris = clip2D(triRender, id2, id1, noTris, viewRightAxis);
-	noTris = clip2D(triRender, id1, id2, noTris, viewTopAxis);
-	noTris = clip2D(triRender, id2, id1, noTris, viewBottomAxis);
-#endif // LE_RENDERER_2DFRAME
+	if (clipMode & LE_CLIPPING_2DFRAME) {
+		noTris = clip2D(triRender, id1, id2, noTris, viewLeftAxis, segment);
+		noTris = clip2D(triRender, id2, id1, noTris, viewRightAxis, segment);
+		noTris = clip2D(triRender, id1, id2, noTris, viewTopAxis, segment);
+		noTris = clip2D(triRender, id2, id1, noTris, viewBottomAxis, segment);
+	}
+
+// Modify the state
+	segment.noUsed = segment.extra;
+	segment.noValid = noTris;
+	segment.stats.noRendered += noTris;
+	closeSegments(1);
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeRenderer::renderRange(const LeMesh * mesh, const LeMatrix & matrix, const int triFlags[], const LeVerList * verlist, int first, int nb, bool inside, Segment & segment)
+	\brief Build, clip, project and cull a range of mesh triangles into a triangle list segment
+	\param[in] mesh pointer to a mesh
+	\param[in] matrix mesh (or instance) view matrix
+	\param[in] triFlags precomputed triangle flags (or NULL)
+	\param[in] verlist transformed vertexes, outcodes and projections
+	\param[in] first first triangle to render
+	\param[in] nb number of triangles to render
+	\param[in] inside mesh fully inside the frustrum (no clipping)
+	\param[in,out] segment destination triangle list segment
+*/
+void LeRenderer::renderRange(const LeMesh * mesh, const LeMatrix & matrix, const int triFlags[], const LeVerList * verlist, int first, int nb, bool inside, Segment & segment)
+{
+	LeTriangle * triRender = &segment.tris[segment.noUsed];
+	int * id1 = &segment.srcIndices[segment.noValid];
+	int * id2 = &segment.dstIndices[segment.noValid];
+
+// Build the triangles (already projected or to be clipped)
+	bool faceCulling = objectCullingEnable && mesh->planes && backMode != LE_BACKCULLING_NONE;
+	int noClip = 0;
+	int clipCodes = 0;
+	int noReady = build(mesh, matrix, triFlags, verlist, first, nb, faceCulling, triRender, id2, id1, noClip, clipCodes);
+	segment.extra = noReady + noClip;
+	segment.extraMax = segment.noAllocated - segment.noUsed;
+
+	Stats & counts = segment.stats;
+	counts.noTriangles += nb;
+	counts.noRejected += nb - segment.extra;
+	counts.noAccepted += noReady;
+	counts.noClipped += noClip;
+
+// Clip the straddling triangles against the crossed planes only
+	int * id3 = &id2[noReady];
+	int * src = id1;
+	int * dst = id3;
+	int noTris = noClip;
+	for (int p = 0; p < noClipPlanes; p++) {
+		if (!(clipCodes & (1 << p))) continue;
+		counts.noPlaneTests += noTris;
+		noTris = clip3D(triRender, src, dst, noTris, *clipPlanes[p], 1 << p, segment);
+		int * tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+	counts.noExtra += segment.extra - noReady - noClip;
+
+// Project the clipped triangles
+	noTris = project(triRender, src, id3, noTris);
+
+// Merge with the projected triangles (backfaces already culled in object space)
+	if (faceCulling) {
+		noTris += noReady;
+		memcpy(id1, id2, noTris * sizeof(int));
+	}else noTris = backculling(triRender, id2, id1, noReady + noTris);
+
+	if ((clipMode & LE_CLIPPING_2DFRAME) && !inside) {
+		noTris = clip2D(triRender, id1, id2, noTris, viewLeftAxis, segment);
+		noTris = clip2D(triRender, id2, id1, noTris, viewRightAxis, segment);
+		noTris = clip2D(triRender, id1, id2, noTris, viewTopAxis, segment);
+		noTris = clip2D(triRender, id2, id1, noTris, viewBottomAxis, segment);
+	}
 
-// Make render indices absolute
+// Make render indices relative to the segment
 	for (int i = 0; i < noTris; i++)
-		id1[i] += usedTrilist->noUsed;
+		id1[i] += segment.noUsed;
 
 // Modify the state
-	usedTrilist->noUsed += extra;
-	usedTrilist->noValid += noTris;
+	segment.noUsed += segment.extra;
+	segment.noValid += noTris;
+	counts.noRendered += noTris;
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeRenderer::openSegments(int noJobs)
+	\brief Share the free triangle list space between the jobs (according to their weights)
+	\param[in] noJobs number of jobs
+*/
+void LeRenderer::openSegments(int noJobs)
+{
+	int freeTriangles = usedTrilist->noAllocated - usedTrilist->noUsed;
+	int total = 0;
+	for (int j = 0; j < noJobs; j++)
+		total += jobs[j].weight;
+
+	int offset = 0;
+	for (int j = 0; j < noJobs; j++) {
+		int size;
+		if (j == noJobs - 1) size = freeTriangles - offset;
+		else if (total) size = (int) (((int64_t) freeTriangles * jobs[j].weight) / total);
+		else size = freeTriangles / noJobs;
+
+		Segment & segment = jobs[j].segment;
+		segment.tris = &usedTrilist->triangles[usedTrilist->noUsed + offset];
+		segment.srcIndices = &usedTrilist->srcIndices[usedTrilist->noValid + offset];
+		segment.dstIndices = &usedTrilist->dstIndices[usedTrilist->noValid + offset];
+		segment.noAllocated = size;
+		segment.noUsed = 0;
+		segment.noValid = 0;
+		memset(&segment.stats, 0, sizeof(Stats));
+		offset += size;
+	}
+}
+
+/**
+	\fn void LeRenderer::closeSegments(int noJobs)
+	\brief Stitch the job segments into the triangle list (in job order)
+	\param[in] noJobs number of jobs
+*/
+void LeRenderer::closeSegments(int noJobs)
+{
+	for (int j = 0; j < noJobs; j++) {
+		Segment & segment = jobs[j].segment;
+
+	// Pack the triangles
+		int base = usedTrilist->noUsed;
+		LeTriangle * tris = &usedTrilist->triangles[base];
+		if (segment.tris != tris)
+			memmove((void *) tris, segment.tris, segment.noUsed * sizeof(LeTriangle));
+
+	// Make render indices absolute
+		int * indices = &usedTrilist->srcIndices[usedTrilist->noValid];
+		for (int i = 0; i < segment.noValid; i++)
+			indices[i] = segment.srcIndices[i] + base;
+
+		usedTrilist->noUsed += segment.noUsed;
+		usedTrilist->noValid += segment.noValid;
+
+	// Merge the statistics
+		stats.noMeshes += segment.stats.noMeshes;
+		stats.noCulled += segment.stats.noCulled;
+		stats.noTriangles += segment.stats.noTriangles;
+		stats.noRejected += segment.stats.noRejected;
+		stats.noAccepted += segment.stats.noAccepted;
+		stats.noClipped += segment.stats.noClipped;
+		stats.noPlaneTests += segment.stats.noPlaneTests;
+		stats.noExtra += segment.stats.noExtra;
+		stats.noDropped += segment.stats.noDropped;
+		stats.noRendered += segment.stats.noRendered;
+	}
+}
+
+/*****************************************************************************/
+void LeRenderer::vertexJob(void * data, int index)
+{
+	LeRenderer * renderer = (LeRenderer *) data;
+	Job * job = &renderer->jobs[index];
+	const LeMesh * mesh = job->meshes[0];
+	renderer->transform(mesh, job->matrices[0], renderer->usedVerlist, job->first, job->nb, job->inside);
+}
+
+void LeRenderer::triangleJob(void * data, int index)
+{
+	LeRenderer * renderer = (LeRenderer *) data;
+	Job * job = &renderer->jobs[index];
+	const LeMesh * mesh = job->meshes[0];
+	renderer->renderRange(mesh, job->matrices[0], NULL, renderer->usedVerlist, job->first, job->nb, job->inside, job->segment);
+}
+
+void LeRenderer::batchJob(void * data, int index)
+{
+	LeRenderer * renderer = (LeRenderer *) data;
+	Job * job = &renderer->jobs[index];
+	Segment & segment = job->segment;
+
+	for (int i = 0; i < job->nb; i++) {
+		const LeMesh * mesh = job->meshes[job->first + i];
+
+	// Cull against the view frustrum
+		segment.stats.noMeshes++;
+		int visibility = renderer->checkBounds(mesh, mesh->view);
+		if (visibility == LE_RENDERER_OUTSIDE) {
+			segment.stats.noCulled++;
+			continue;
+		}
+		bool inside = visibility == LE_RENDERER_INSIDE;
+
+	// Render in the thread own segment
+		if (!renderer->checkMemory(job->verlist, segment, mesh->noVertexes, mesh->noTriangles)) {
+			segment.stats.noDropped++;
+			continue;
+		}
+		renderer->transform(mesh, mesh->view, job->verlist, 0, mesh->noVertexes, inside);
+		renderer->renderRange(mesh, mesh->view, NULL, job->verlist, 0, mesh->noTriangles, inside, segment);
+	}
+}
+
+void LeRenderer::instanceJob(void * data, int index)
+{
+	LeRenderer * renderer = (LeRenderer *) data;
+	Job * job = &renderer->jobs[index];
+	Segment & segment = job->segment;
+	const LeMesh * mesh = job->meshes[0];
+
+	for (int i = 0; i < job->nb; i++) {
+		const LeMatrix & matrix = job->matrices[job->first + i];
+
+	// Cull against the view frustrum
+		segment.stats.noMeshes++;
+		int visibility = renderer->checkBounds(mesh, matrix);
+		if (visibility == LE_RENDERER_OUTSIDE) {
+			segment.stats.noCulled++;
+			continue;
+		}
+		bool inside = visibility == LE_RENDERER_INSIDE;
+
+	// Render in the thread own segment
+		if (!renderer->checkMemory(job->verlist, segment, mesh->noVertexes, mesh->noTriangles)) {
+			segment.stats.noDropped++;
+			continue;
+		}
+		renderer->transform(mesh, matrix, job->verlist, 0, mesh->noVertexes, inside);
+		renderer->renderRange(mesh, matrix, renderer->instFlags, job->verlist, 0, mesh->noTriangles, inside, segment);
+	}
 }
 
 /*****************************************************************************/
@@ -209,23 +586,133 @@ int LeRenderer::getViewportCoordinates(const LeVertex & pos, LeVertex & viewCoor
 
 /*****************************************************************************/
 /**
-	\fn bool LeRenderer::checkMemory(int noVertexes, int noTriangles)
+	\fn bool LeRenderer::checkMemory(const LeVerList * verlist, const Segment & segment, int noVertexes, int noTriangles)
 	\brief Check if there is enough memory to render
+	\param[in] verlist vertex workspace
+	\param[in] segment destination triangle list segment
 	\param[in] noVertexes number of vertexes
 	\param[in] noTriangles number of triangles
 	\return true if enough memory available, false else
 */
-bool LeRenderer::checkMemory(int noVertexes, int noTriangles)
+bool LeRenderer::checkMemory(const LeVerList * verlist, const Segment & segment, int noVertexes, int noTriangles)
 {
-	if (noVertexes > usedVerlist->noAllocated) return false;
-	usedVerlist->noUsed = 0;
-
-	int freeTriangles = usedTrilist->noAllocated - usedTrilist->noUsed;
+	if (noVertexes > verlist->noAllocated) return false;
+	int freeTriangles = segment.noAllocated - segment.noUsed;
 	if (noTriangles > freeTriangles) return false;
-	extraMax = freeTriangles;
-
 	return true;
 }
+/**
+	\fn void LeRenderer::reserveLists(int noJobs, int noVertexes, int noTriangles)
+	\brief Grow the job vertex lists and the triangle list before rendering
+	\param[in] noJobs number of jobs
+	\param[in] noVertexes number of vertexes per job
+	\param[in] noTriangles number of triangles (twice the room is kept for clipping)
+*/
+void LeRenderer::reserveLists(int noJobs, int noVertexes, int noTriangles)
+{
+	for (int j = 0; j < noJobs; j++)
+		jobs[j].verlist->reserve(noVertexes);
+	int64_t needed = (int64_t) usedTrilist->noUsed + (int64_t) noTriangles * 2;
+	usedTrilist->reserve((int) cmmin(needed, (int64_t) LE_TRILIST_MAX));
+}
+
+/*****************************************************************************/
+/**
+	\fn int LeRenderer::checkBounds(const LeMesh * mesh, const LeMatrix & matrix)
+	\brief Check the mesh bounding volumes against the view frustrum
+	\param[in] mesh pointer to a mesh
+	\param[in] matrix mesh (or instance) view matrix
+	\return visibility of the mesh (outside: culled, inside: rendered without outcodes nor clipping)
+*/
+int LeRenderer::checkBounds(const LeMesh * mesh, const LeMatrix & matrix)
+{
+	if (mesh->boundRadius < 0.0f) return LE_RENDERER_PARTIAL;
+
+	const LePlane * planes[6] = {
+		&viewFrontPlan, &viewBackPlan,
+		&viewLeftPlan, &viewRightPlan,
+		&viewTopPlan, &viewBotPlan
+	};
+
+// Transform the bounding sphere
+	LeMatrix view = viewMatrix * matrix;
+	LeVertex center;
+	float radius;
+	transformSphere(mesh, view, center, radius);
+
+// Test the sphere against the frustrum
+	bool inside = true;
+	for (int p = 0; p < 6; p++) {
+		const LeAxis * axis = &planes[p]->zAxis;
+		float d = (center - axis->origin).dot(axis->axis);
+		if (d < -radius) return LE_RENDERER_OUTSIDE;
+		if (d < radius) inside = false;
+	}
+	if (inside) return LE_RENDERER_INSIDE;
+
+// Refine with the bounding box corners
+	LeVertex corners[8];
+	for (int c = 0; c < 8; c++) {
+		LeVertex v;
+		v.x = (c & 1) ? mesh->boundMax.x : mesh->boundMin.x;
+		v.y = (c & 2) ? mesh->boundMax.y : mesh->boundMin.y;
+		v.z = (c & 4) ? mesh->boundMax.z : mesh->boundMin.z;
+		corners[c] = view * v;
+	}
+
+	inside = true;
+	for (int p = 0; p < 6; p++) {
+		const LeAxis * axis = &planes[p]->zAxis;
+		int noOutside = 0;
+		for (int c = 0; c < 8; c++) {
+			float d = (corners[c] - axis->origin).dot(axis->axis);
+			if (d < 0.0f) noOutside++;
+		}
+		if (noOutside == 8) return LE_RENDERER_OUTSIDE;
+		if (noOutside) inside = false;
+	}
+	if (inside) return LE_RENDERER_INSIDE;
+	return LE_RENDERER_PARTIAL;
+}
+
+/**
+	\fn float LeRenderer::getProjectedRadius(const LeMesh * mesh, const LeMatrix & matrix)
+	\brief Return the projected radius of the mesh bounding sphere
+	\param[in] mesh pointer to a mesh
+	\param[in] matrix mesh (or instance) view matrix
+	\return projected radius (in pixels, very large if the view is inside the sphere)
+*/
+float LeRenderer::getProjectedRadius(const LeMesh * mesh, const LeMatrix & matrix)
+{
+	if (mesh->boundRadius < 0.0f) return FLT_MAX;
+
+	LeMatrix view = viewMatrix * matrix;
+	LeVertex center;
+	float radius;
+	transformSphere(mesh, view, center, radius);
+
+	float distance = -center.z;
+	if (distance <= radius) return FLT_MAX;
+	return radius * fabsf(ztx) / distance;
+}
+
+/**
+	\fn void LeRenderer::transformSphere(const LeMesh * mesh, const LeMatrix & view, LeVertex & center, float & radius)
+	\brief Transform the mesh bounding sphere in view space
+	\param[in] mesh pointer to a mesh
+	\param[in] view mesh to view space matrix
+	\param[out] center sphere center (view space)
+	\param[out] radius sphere radius (view space, largest axis scaling)
+*/
+void LeRenderer::transformSphere(const LeMesh * mesh, const LeMatrix & view, LeVertex & center, float & radius)
+{
+	center = view * mesh->boundCenter;
+
+	float sx = view.mat[0][0] * view.mat[0][0] + view.mat[1][0] * view.mat[1][0] + view.mat[2][0] * view.mat[2][0];
+	float sy = view.mat[0][1] * view.mat[0][1] + view.mat[1][1] * view.mat[1][1] + view.mat[2][1] * view.mat[2][1];
+	float sz = view.mat[0][2] * view.mat[0][2] + view.mat[1][2] * view.mat[1][2] + view.mat[2][2] * view.mat[2][2];
+	radius = mesh->boundRadius * sqrtf(cmmax(sx, cmmax(sy, sz)));
+}
 
 /*****************************************************************************/
 /**
@@ -234,8 +721,11 @@ bool LeRenderer::checkMemory(int noVertexes, int noTriangles)
 */
 void LeRenderer::flush()
 {
-	usedTrilist->noUsed = 0;
-	usedTrilist->noValid = 0;
+	usedTrilist->flush();
+	usedVerlist->flush();
+	for (int j = 0; j < noThreads - 1; j++)
+		threadVerlists[j].flush();
+	memset(&stats, 0, sizeof(Stats));
 }
 
 /*****************************************************************************/
@@ -260,6 +750,16 @@ LeTriList * LeRenderer::getTriangleList()
 	return usedTrilist;
 }
 
+/**
+	\fn const LeRenderer::Stats & LeRenderer::getStats()
+	\brief Get the renderer statistics (accumulated since last flush)
+	\return renderer statistics
+*/
+const LeRenderer::Stats & LeRenderer::getStats()
+{
+	return stats;
+}
+
 /*****************************************************************************/
 /**
 	\fn void LeRenderer::setViewPosition(const LeVertex & pos)
@@ -374,6 +874,39 @@ void LeRenderer::setBackcullingMode(LE_BACKCULLING_MODES mode)
 	backMode = mode;
 }
 
+/**
+	\fn void LeRenderer::setObjectCulling(bool enable)
+	\brief Enable or disable backculling in object space (before clipping, for meshes with face planes)
+	\param[in] enable object space backculling enable state
+*/
+void LeRenderer::setObjectCulling(bool enable)
+{
+	objectCullingEnable = enable;
+}
+
+/**
+	\fn void LeRenderer::setClippingMode(int modes)
+	\brief Set the clipping modes (combination of LE_CLIPPING_MODES)
+	\param[in] modes clipping modes
+*/
+void LeRenderer::setClippingMode(int modes)
+{
+	if (!modes) return;
+	clipMode = modes;
+	updateFrustrum();
+}
+
+/**
+	\fn void LeRenderer::setGuardBand(float ratio)
+	\brief Set the guard band size (with LE_CLIPPING_GUARDBAND mode)
+	\param[in] ratio guard band size (ratio of the viewport size, minimum 1.0)
+*/
+void LeRenderer::setGuardBand(float ratio)
+{
+	guardRatio = cmmax(ratio, 1.0f);
+	updateFrustrum();
+}
+
 /**
 	\fn void LeRenderer::setMipmapping(bool enable)
 	\brief Enable or disable texture mipmapping
@@ -384,6 +917,39 @@ void LeRenderer::setMipmapping(bool enable)
 	mipmappingEnable = enable;
 }
 
+/**
+	\fn void LeRenderer::setThreads(int count)
+	\brief Set the number of geometry threads
+	\param[in] count number of threads (including the calling thread, 0 for one per processor)
+*/
+void LeRenderer::setThreads(int count)
+{
+	if (count <= 0) count = LeThreadPool::getNoProcessors();
+	if (count == noThreads) return;
+
+	pool.start(count);
+	noThreads = pool.getNoThreads();
+
+// Allocate the jobs and their vertex lists
+	if (jobs) delete[] jobs;
+	if (threadVerlists) delete[] threadVerlists;
+	jobs = new Job[noThreads];
+	threadVerlists = NULL;
+	if (noThreads > 1) threadVerlists = new LeVerList[noThreads - 1];
+	for (int j = 0; j < noThreads; j++)
+		jobs[j].verlist = j ? &threadVerlists[j - 1] : usedVerlist;
+}
+
+/**
+	\fn int LeRenderer::getThreads()
+	\brief Get the number of geometry threads
+	\return number of threads (including the calling thread)
+*/
+int LeRenderer::getThreads()
+{
+	return noThreads;
+}
+
 /**
 	\fn void LeRenderer::setFog(bool enable)
 	\brief Enable or disable quadratic ambient fog
@@ -431,9 +997,66 @@ void LeRenderer::updateFrustrum()
 	float wb = wf * dr;
 	viewLeftPlan = LePlane(LeVertex(wf, 0.0f, near), LeVertex(wb, 0.0f, far), LeVertex(wf,  1.0f, near));
 	viewRightPlan = LePlane(LeVertex(-wf, 0.0f, near), LeVertex(-wb, 0.0f, far), LeVertex(-wf, -1.0f, near));
+
+	float gh = hf * guardRatio;
+	float gb = hb * guardRatio;
+	guardTopPlan = LePlane(LeVertex(0.0f, -gb, far), LeVertex(1.0f, -gb, far), LeVertex(0.0f, -gh, near));
+	guardBotPlan = LePlane(LeVertex(0.0f, gb, far), LeVertex(-1.0f, gb, far), LeVertex(0.0f, gh, near));
+
+	float gf = wf * guardRatio;
+	float gw = wb * guardRatio;
+	guardLeftPlan = LePlane(LeVertex(gf, 0.0f, near), LeVertex(gw, 0.0f, far), LeVertex(gf,  1.0f, near));
+	guardRightPlan = LePlane(LeVertex(-gf, 0.0f, near), LeVertex(-gw, 0.0f, far), LeVertex(-gf, -1.0f, near));
+
+// Select the clipping planes
+	bool guard = (clipMode & LE_CLIPPING_GUARDBAND) != 0;
+	clipPlanes[0] = &viewFrontPlan;
+	clipPlanes[1] = &viewBackPlan;
+	clipPlanes[2] = guard ? &guardLeftPlan : &viewLeftPlan;
+	clipPlanes[3] = guard ? &guardRightPlan : &viewRightPlan;
+	clipPlanes[4] = guard ? &guardTopPlan : &viewTopPlan;
+	clipPlanes[5] = guard ? &guardBotPlan : &viewBotPlan;
+	noClipPlanes = (clipMode & (LE_CLIPPING_3DFRUSTRUM | LE_CLIPPING_GUARDBAND)) ? 6 : 2;
+
+// Build the outcode plane equations (guard band mode rejects against the viewport sides)
+	const LePlane * codeSides[4] = {&viewLeftPlan, &viewRightPlan, &viewTopPlan, &viewBotPlan};
+	noCodePlanes = guard ? 10 : 6;
+	for (int p = 0; p < noCodePlanes; p++) {
+		const LeAxis * axis = p < 6 ? &clipPlanes[p]->zAxis : &codeSides[p - 6]->zAxis;
+		codePlanes[p][0] = axis->axis.x;
+		codePlanes[p][1] = axis->axis.y;
+		codePlanes[p][2] = axis->axis.z;
+		codePlanes[p][3] = -axis->origin.dot(axis->axis);
+	}
 }
 
 /*****************************************************************************/
+/**
+	\fn void LeRenderer::transform(const LeMesh * mesh, const LeMatrix & matrix, LeVerList * verlist, int first, int nb, bool inside)
+	\brief Transform, compute the outcodes and project a range of mesh vertexes
+	\param[in] mesh pointer to a mesh
+	\param[in] matrix mesh (or instance) view matrix
+	\param[out] verlist destination vertex list
+	\param[in] first first vertex to transform
+	\param[in] nb number of vertexes
+	\param[in] inside mesh fully inside the frustrum (null outcodes)
+*/
+void LeRenderer::transform(const LeMesh * mesh, const LeMatrix & matrix, LeVerList * verlist, int first, int nb, bool inside)
+{
+	LeVertex * vertexes = &verlist->vertexes[first];
+	uint16_t * codes = &verlist->codes[first];
+
+	if (mesh->positions) {
+		int stride = (mesh->noVertexes + 7) & ~7;
+		transform(matrix, &mesh->positions[first], stride, vertexes, codes, nb, inside);
+	}else{
+		transform(matrix, &mesh->vertexes[first], vertexes, nb);
+		if (inside) memset(codes, 0, nb * sizeof(uint16_t));
+		else outcodes(vertexes, codes, nb);
+	}
+	project(vertexes, codes, &verlist->projected[first], nb);
+}
+
 /**
 	\fn void LeRenderer::transform(LeMatrix view, const LeVertex srcVertexes[], LeVertex dstVertexes[], int nb)
 	\brief Transform the vertexes by the specified matrix and the view matrix
@@ -449,46 +1072,246 @@ void LeRenderer::transform(const LeMatrix & matrix, const LeVertex srcVertexes[]
 		dstVertexes[i] = view * srcVertexes[i];
 }
 
+/**
+	\fn void LeRenderer::transform(const LeMatrix & matrix, const float positions[], int stride, LeVertex dstVertexes[], uint16_t codes[], int nb, bool inside)
+	\brief Transform a vertex positions stream and compute the vertexes outcodes
+	\param[in] matrix transform matrix
+	\param[in] positions source positions stream (x, y, z blocks padded to 8 vertexes)
+	\param[in] stride distance between the x, y and z blocks
+	\param[out] dstVertexes destination vertex buffer
+	\param[out] codes destination outcode buffer
+	\param[in] nb number of vertexes
+	\param[in] inside vertexes all inside the frustrum (null outcodes)
+*/
+void LeRenderer::transform(const LeMatrix & matrix, const float positions[], int stride, LeVertex dstVertexes[], uint16_t codes[], int nb, bool inside)
+{
+	LeMatrix view = viewMatrix * matrix;
+	const float * xs = positions;
+	const float * ys = positions + stride;
+	const float * zs = positions + stride * 2;
+	int i = 0;
+
+#if LE_USE_SIMD == 1 && LE_USE_AVX2 == 1
+// Process 8 vertexes per iteration
+	__m256 m[3][4];
+	for (int r = 0; r < 3; r++)
+		for (int c = 0; c < 4; c++)
+			m[r][c] = _mm256_set1_ps(view.mat[r][c]);
+
+	int noPlanes = inside ? 0 : noCodePlanes;
+	__m256 pl[10][4];
+	__m256i bits[10];
+	for (int p = 0; p < noPlanes; p++) {
+		for (int c = 0; c < 4; c++)
+			pl[p][c] = _mm256_set1_ps(codePlanes[p][c]);
+		bits[p] = _mm256_set1_epi32(1 << p);
+	}
+
+	const __m256 zero = _mm256_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	int32_t c32[8];
+
+	for (; i + 8 <= nb; i += 8) {
+		__m256 x = _mm256_loadu_ps(&xs[i]);
+		__m256 y = _mm256_loadu_ps(&ys[i]);
+		__m256 z = _mm256_loadu_ps(&zs[i]);
+
+		__m256 tx = _mm256_fmadd_ps(m[0][0], x, _mm256_fmadd_ps(m[0][1], y, _mm256_fmadd_ps(m[0][2], z, m[0][3])));
+		__m256 ty = _mm256_fmadd_ps(m[1][0], x, _mm256_fmadd_ps(m[1][1], y, _mm256_fmadd_ps(m[1][2], z, m[1][3])));
+		__m256 tz = _mm256_fmadd_ps(m[2][0], x, _mm256_fmadd_ps(m[2][1], y, _mm256_fmadd_ps(m[2][2], z, m[2][3])));
+
+	// Compute the outcodes
+		__m256i code = _mm256_setzero_si256();
+		for (int p = 0; p < noPlanes; p++) {
+			__m256 d = _mm256_fmadd_ps(pl[p][0], tx, _mm256_fmadd_ps(pl[p][1], ty, _mm256_fmadd_ps(pl[p][2], tz, pl[p][3])));
+			__m256i out = _mm256_castps_si256(_mm256_cmp_ps(d, zero, _CMP_LT_OQ));
+			code = _mm256_or_si256(code, _mm256_and_si256(out, bits[p]));
+		}
+		_mm256_storeu_si256((__m256i *) c32, code);
+		for (int k = 0; k < 8; k++)
+			codes[i + k] = (uint16_t) c32[k];
+
+	// Store back as vertexes
+		for (int h = 0; h < 2; h++) {
+			__m128 vx = h ? _mm256_extractf128_ps(tx, 1) : _mm256_castps256_ps128(tx);
+			__m128 vy = h ? _mm256_extractf128_ps(ty, 1) : _mm256_castps256_ps128(ty);
+			__m128 vz = h ? _mm256_extractf128_ps(tz, 1) : _mm256_castps256_ps128(tz);
+			__m128 vw = one;
+			_MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+			float * dst = &dstVertexes[i + h * 4].x;
+			_mm_storeu_ps(&dst[0], vx);
+			_mm_storeu_ps(&dst[4], vy);
+			_mm_storeu_ps(&dst[8], vz);
+			_mm_storeu_ps(&dst[12], vw);
+		}
+	}
+#elif LE_USE_SIMD == 1 && LE_USE_SSE2 == 1
+// Process 4 vertexes per iteration
+	__m128 m[3][4];
+	for (int r = 0; r < 3; r++)
+		for (int c = 0; c < 4; c++)
+			m[r][c] = _mm_set1_ps(view.mat[r][c]);
+
+	int noPlanes = inside ? 0 : noCodePlanes;
+	__m128 pl[10][4];
+	__m128i bits[10];
+	for (int p = 0; p < noPlanes; p++) {
+		for (int c = 0; c < 4; c++)
+			pl[p][c] = _mm_set1_ps(codePlanes[p][c]);
+		bits[p] = _mm_set1_epi32(1 << p);
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	int32_t c32[4];
+
+	for (; i + 4 <= nb; i += 4) {
+		__m128 x = _mm_loadu_ps(&xs[i]);
+		__m128 y = _mm_loadu_ps(&ys[i]);
+		__m128 z = _mm_loadu_ps(&zs[i]);
+
+		__m128 tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][0]), _mm_mul_ps(y, m[0][1])), _mm_mul_ps(z, m[0][2])), m[0][3]);
+		__m128 ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[1][0]), _mm_mul_ps(y, m[1][1])), _mm_mul_ps(z, m[1][2])), m[1][3]);
+		__m128 tz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[2][0]), _mm_mul_ps(y, m[2][1])), _mm_mul_ps(z, m[2][2])), m[2][3]);
+
+	// Compute the outcodes
+		__m128i code = _mm_setzero_si128();
+		for (int p = 0; p < noPlanes; p++) {
+			__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pl[p][0], tx), _mm_mul_ps(pl[p][1], ty)), _mm_add_ps(_mm_mul_ps(pl[p][2], tz), pl[p][3]));
+			__m128i out = _mm_castps_si128(_mm_cmplt_ps(d, zero));
+			code = _mm_or_si128(code, _mm_and_si128(out, bits[p]));
+		}
+		_mm_storeu_si128((__m128i *) c32, code);
+		codes[i + 0] = (uint16_t) c32[0];
+		codes[i + 1] = (uint16_t) c32[1];
+		codes[i + 2] = (uint16_t) c32[2];
+		codes[i + 3] = (uint16_t) c32[3];
+
+	// Store back as vertexes
+		__m128 tw = one;
+		_MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+		float * dst = &dstVertexes[i].x;
+		_mm_storeu_ps(&dst[0], tx);
+		_mm_storeu_ps(&dst[4], ty);
+		_mm_storeu_ps(&dst[8], tz);
+		_mm_storeu_ps(&dst[12], tw);
+	}
+#endif // LE_USE_SIMD && LE_USE_AVX2
+
+// Process remaining vertexes
+	int t = i;
+	for (; i < nb; i++) {
+		LeVertex * v = &dstVertexes[i];
+		v->x = xs[i] * view.mat[0][0] + ys[i] * view.mat[0][1] + zs[i] * view.mat[0][2] + view.mat[0][3];
+		v->y = xs[i] * view.mat[1][0] + ys[i] * view.mat[1][1] + zs[i] * view.mat[1][2] + view.mat[1][3];
+		v->z = xs[i] * view.mat[2][0] + ys[i] * view.mat[2][1] + zs[i] * view.mat[2][2] + view.mat[2][3];
+		v->w = 1.0f;
+	}
+	if (inside) memset(&codes[t], 0, (nb - t) * sizeof(uint16_t));
+	else outcodes(&dstVertexes[t], &codes[t], nb - t);
+}
+
+/**
+	\fn void LeRenderer::outcodes(const LeVertex vertexes[], uint16_t codes[], int nb)
+	\brief Compute the outcodes of transformed vertexes
+	\param[in] vertexes transformed vertexes
+	\param[out] codes destination outcode buffer
+	\param[in] nb number of vertexes
+*/
+void LeRenderer::outcodes(const LeVertex vertexes[], uint16_t codes[], int nb)
+{
+	for (int i = 0; i < nb; i++) {
+		const LeVertex * v = &vertexes[i];
+		uint16_t code = 0;
+		for (int p = 0; p < noCodePlanes; p++) {
+			float d = v->x * codePlanes[p][0] + v->y * codePlanes[p][1] + v->z * codePlanes[p][2] + codePlanes[p][3];
+			if (d < 0.0f) code |= 1 << p;
+		}
+		codes[i] = code;
+	}
+}
+
 /*****************************************************************************/
-int LeRenderer::build(const LeMesh * mesh, LeVertex vertexes[], LeTriangle tris[], int indices[])
+/**
+	\fn int LeRenderer::build(const LeMesh * mesh, const LeMatrix & matrix, const int triFlags[], const LeVerList * verlist, int first, int nb, bool faceCulling, LeTriangle tris[], int readyIndices[], int clipIndices[], int & noClip, int & clipCodes)
+	\brief Build the mesh triangles from the transformed and projected vertexes
+	\param[in] mesh pointer to a mesh
+	\param[in] matrix mesh (or instance) view matrix
+	\param[in] triFlags precomputed triangle flags (or NULL)
+	\param[in] verlist transformed vertexes, outcodes and projections
+	\param[in] first first triangle to build
+	\param[in] nb number of triangles to build
+	\param[in] faceCulling cull the backfaces with the mesh face planes
+	\param[out] tris destination triangles
+	\param[out] readyIndices indexes of triangles inside the frustrum (already projected)
+	\param[out] clipIndices indexes of triangles straddling the frustrum (to be clipped)
+	\param[out] noClip number of triangles to be clipped
+	\param[out] clipCodes planes crossed by the triangles to be clipped
+	\return number of triangles already projected
+*/
+int LeRenderer::build(const LeMesh * mesh, const LeMatrix & matrix, const int triFlags[], const LeVerList * verlist, int first, int nb, bool faceCulling, LeTriangle tris[], int readyIndices[], int clipIndices[], int & noClip, int & clipCodes)
 {
 	int k = 0;
-	float near = viewFrontPlan.zAxis.origin.z;
-	float far = viewBackPlan.zAxis.origin.z;
+	int noReady = 0;
+	noClip = 0;
+	clipCodes = 0;
 
-	if (mesh->shades) colors = mesh->shades;
-	else colors = mesh->colors;
+	const LeVertex * vertexes = verlist->vertexes;
+	const LeVertex * projected = verlist->projected;
+	const uint16_t * codes = verlist->codes;
+
+	const LeColor * colors = mesh->shades ? mesh->shades : mesh->colors;
 
 	int flags = LE_TRIANGLE_TEXTURED;
 	if (mipmappingEnable) flags |= LE_TRIANGLE_MIPMAPPED;
 	if (fogEnable) flags |= LE_TRIANGLE_FOGGED;
 
-	for (int i = 0; i < mesh->noTriangles; i++) {
-		LeVertex * v1 = &vertexes[mesh->vertexesList[i*3]];
-		LeVertex * v2 = &vertexes[mesh->vertexesList[i*3+1]];
-		LeVertex * v3 = &vertexes[mesh->vertexesList[i*3+2]];
+// Compute the eye position in object space
+	LeVertex eye;
+	float side = 0.0f;
+	bool alpha = backMode == LE_BACKCULLING_CCW_ALPHA || backMode == LE_BACKCULLING_CW_ALPHA;
+	if (faceCulling) {
+		LeMatrix view = viewMatrix * matrix;
+		eye = view.inverse3x3() * LeVertex(-view.mat[0][3], -view.mat[1][3], -view.mat[2][3]);
+
+	// Mirroring transforms swap the faces
+		LeVertex ax(view.mat[0][0], view.mat[1][0], view.mat[2][0]);
+		LeVertex ay(view.mat[0][1], view.mat[1][1], view.mat[2][1]);
+		LeVertex az(view.mat[0][2], view.mat[1][2], view.mat[2][2]);
+		side = ax.cross(ay).dot(az) < 0.0f ? -1.0f : 1.0f;
+		if (backMode == LE_BACKCULLING_CW || backMode == LE_BACKCULLING_CW_ALPHA) side = -side;
+	}
 
-	// Hard clip
-		if (v1->z > near && v2->z > near && v3->z > near) continue;
-		if (v1->z <= far && v2->z <= far && v3->z <= far) continue;
+	for (int i = first; i < first + nb; i++) {
+		int a = mesh->vertexesList[i*3];
+		int b = mesh->vertexesList[i*3+1];
+		int c = mesh->vertexesList[i*3+2];
 
-	// Fetch triangle properties
+	// Hard clip (against the viewport sides in guard band mode)
+		if (codes[a] & codes[b] & codes[c]) continue;
+
+	// Fetch triangle properties (default slot: untextured)
 		int texSlot = mesh->texSlotList[i];
 		int subFlags = flags;
-		if (bmpCache.cacheSlots[texSlot].flags & LE_BITMAP_RGBA)
+		if (triFlags) subFlags = triFlags[i];
+		else if (!texSlot) subFlags &= ~LE_TRIANGLE_TEXTURED;
+		else if (bmpCache.cacheSlots[texSlot].flags & LE_BMPCACHE_CUTOUT)
+			subFlags |= LE_TRIANGLE_CUTOUT;
+		else if (bmpCache.cacheSlots[texSlot].flags & LE_BMPCACHE_RGBA)
 			subFlags |= LE_TRIANGLE_BLENDED;
 
-	// Copy coordinates (for clipping)
+	// Cull the backfaces (transparent triangles are double sided in alpha modes)
+		if (faceCulling && !(alpha && (subFlags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT)))) {
+			const LeVertex * p = &mesh->planes[i];
+			float d = p->x * eye.x + p->y * eye.y + p->z * eye.z + p->w;
+			if (d * side < 0.0f) continue;
+		}
+
+		const LeVertex * v1 = &vertexes[a];
+		const LeVertex * v2 = &vertexes[b];
+		const LeVertex * v3 = &vertexes[c];
+
 		LeTriangle * tri = &tris[k];
-		tri->xs[0] = v1->x;
-		tri->ys[0] = v1->y;
-		tri->zs[0] = v1->z;
-		tri->xs[1] = v2->x;
-		tri->ys[1] = v2->y;
-		tri->zs[1] = v2->z;
-		tri->xs[2] = v3->x;
-		tri->ys[2] = v3->y;
-		tri->zs[2] = v3->z;
 		int m1 = 2 * mesh->texCoordsList[i*3];
 		tri->us[0] = mesh->texCoords[m1];
 		tri->vs[0] = mesh->texCoords[m1+1];
@@ -500,9 +1323,9 @@ int LeRenderer::build(const LeMesh * mesh, LeVertex vertexes[], LeTriangle tris[
 		tri->vs[2] = mesh->texCoords[m3+1];
 
 	// Compute view distance
-		float d1 = tri->zs[0] + tri->zs[1] + tri->zs[2];
-		float d2 = tri->ys[0] + tri->ys[1] + tri->ys[2];
-		float d3 = tri->xs[0] + tri->xs[1] + tri->xs[2];
+		float d1 = v1->z + v2->z + v3->z;
+		float d2 = v1->y + v2->y + v3->y;
+		float d3 = v1->x + v2->x + v3->x;
 		tri->vd = d1 * d1 + d2 * d2 + d3 * d3 - vOffset;
 
 	// Set material properties
@@ -510,10 +1333,46 @@ int LeRenderer::build(const LeMesh * mesh, LeVertex vertexes[], LeTriangle tris[
 		tri->diffuseTexture = texSlot;
 		tri->flags = subFlags;
 
-		indices[k] = k;
+		int crossed = (codes[a] | codes[b] | codes[c]) & LE_VERLIST_CODE_CLIP;
+		if (crossed) {
+		// Copy coordinates (for clipping)
+			tri->flags |= crossed << 8;
+			clipCodes |= crossed;
+			tri->xs[0] = v1->x;
+			tri->ys[0] = v1->y;
+			tri->zs[0] = v1->z;
+			tri->xs[1] = v2->x;
+			tri->ys[1] = v2->y;
+			tri->zs[1] = v2->z;
+			tri->xs[2] = v3->x;
+			tri->ys[2] = v3->y;
+			tri->zs[2] = v3->z;
+			clipIndices[noClip++] = k;
+		}else{
+		// Copy projected coordinates
+			const LeVertex * p1 = &projected[a];
+			const LeVertex * p2 = &projected[b];
+			const LeVertex * p3 = &projected[c];
+			tri->xs[0] = p1->x;
+			tri->ys[0] = p1->y;
+			tri->zs[0] = p1->z;
+			tri->xs[1] = p2->x;
+			tri->ys[1] = p2->y;
+			tri->zs[1] = p2->z;
+			tri->xs[2] = p3->x;
+			tri->ys[2] = p3->y;
+			tri->zs[2] = p3->z;
+			tri->us[0] *= p1->z;
+			tri->us[1] *= p2->z;
+			tri->us[2] *= p3->z;
+			tri->vs[0] *= p1->z;
+			tri->vs[1] *= p2->z;
+			tri->vs[2] *= p3->z;
+			readyIndices[noReady++] = k;
+		}
 		k++;
 	}
-	return k;
+	return noReady;
 }
 
 int LeRenderer::build(const LeBSet * bset, LeVertex vertexes[], LeTriangle tris[], int indices[])
@@ -522,10 +1381,9 @@ int LeRenderer::build(const LeBSet * bset, LeVertex vertexes[], LeTriangle tris[
 	float near = viewFrontPlan.zAxis.origin.z;
 	float far = viewBackPlan.zAxis.origin.z;
 
-	if (bset->shades) colors = bset->shades;
-	else colors = bset->colors;
+	const LeColor * colors = bset->shades ? bset->shades : bset->colors;
 
-	int flags = LE_TRIANGLE_TEXTURED;
+	int flags = LE_TRIANGLE_TEXTURED | LE_TRIANGLE_CLIPCODES;
 	if (mipmappingEnable) flags |= LE_TRIANGLE_MIPMAPPED;
 	if (fogEnable) flags |= LE_TRIANGLE_FOGGED;
 
@@ -540,10 +1398,13 @@ int LeRenderer::build(const LeBSet * bset, LeVertex vertexes[], LeTriangle tris[
 		float sx = bset->sizes[i * 2 + 0] * 0.5f;
 		float sy = bset->sizes[i * 2 + 1] * 0.5f;
 		
-	// Fetch billboard properties
+	// Fetch billboard properties (default slot: untextured)
 		int texSlot = bset->texSlots[i];
 		int subFlags = flags;
-		if (bmpCache.cacheSlots[texSlot].flags & LE_BITMAP_RGBA)
+		if (!texSlot) subFlags &= ~LE_TRIANGLE_TEXTURED;
+		else if (bmpCache.cacheSlots[texSlot].flags & LE_BMPCACHE_CUTOUT)
+			subFlags |= LE_TRIANGLE_CUTOUT;
+		else if (bmpCache.cacheSlots[texSlot].flags & LE_BMPCACHE_RGBA)
 			subFlags |= LE_TRIANGLE_BLENDED;
 
 	// First triangle
@@ -608,6 +1469,33 @@ int LeRenderer::build(const LeBSet * bset, LeVertex vertexes[], LeTriangle tris[
 }
 
 /*****************************************************************************/
+/**
+	\fn void LeRenderer::project(const LeVertex vertexes[], const uint16_t codes[], LeVertex projected[], int nb)
+	\brief Project the vertexes inside the frustrum on the viewport
+	\param[in] vertexes transformed vertexes
+	\param[in] codes vertexes outcodes
+	\param[out] projected projected vertexes (x, y on viewport and w in z)
+	\param[in] nb number of vertexes
+*/
+void LeRenderer::project(const LeVertex vertexes[], const uint16_t codes[], LeVertex projected[], int nb)
+{
+	float width = viewRightAxis.origin.x - viewLeftAxis.origin.x;
+	float height = viewBottomAxis.origin.y - viewTopAxis.origin.y;
+	float centerX = viewLeftAxis.origin.x + width * 0.5f;
+	float centerY = viewTopAxis.origin.y + height * 0.5f;
+	float near = -viewFrontPlan.zAxis.origin.z;
+
+	for (int i = 0; i < nb; i++) {
+		if (codes[i] & LE_VERLIST_CODE_CLIP) continue;
+		const LeVertex * v = &vertexes[i];
+		LeVertex * p = &projected[i];
+		float w = near / v->z;
+		p->x = v->x * ztx * w + centerX;
+		p->y = centerY - v->y * zty * w;
+		p->z = w;
+	}
+}
+
 int LeRenderer::project(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb)
 {
 	int k = 0;
@@ -659,15 +1547,21 @@ int LeRenderer::project(LeTriangle tris[], const int srcIndices[], int dstIndice
 }
 
 /*****************************************************************************/
-int LeRenderer::clip3D(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb, LePlane &plane)
+int LeRenderer::clip3D(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb, LePlane &plane, int code, Segment & segment)
 {
 	int k = 0;
 	for (int i = 0; i < nb; i++) {
 		int s = 0;
 		int j = srcIndices[i];
 
-	// Project against clipping plane
+	// Skip triangles not crossing the plane
 		LeTriangle * tri = &tris[j];
+		if (!(tri->flags & (code << 8))) {
+			dstIndices[k++] = j;
+			continue;
+		}
+
+	// Project against clipping plane
 		float pj1 = (tri->xs[0] - plane.zAxis.origin.x) * plane.zAxis.axis.x + (tri->ys[0] - plane.zAxis.origin.y) * plane.zAxis.axis.y + (tri->zs[0] - plane.zAxis.origin.z) * plane.zAxis.axis.z;
 		float pj2 = (tri->xs[1] - plane.zAxis.origin.x) * plane.zAxis.axis.x + (tri->ys[1] - plane.zAxis.origin.y) * plane.zAxis.axis.y + (tri->zs[1] - plane.zAxis.origin.z) * plane.zAxis.axis.z;
 		float pj3 = (tri->xs[2] - plane.zAxis.origin.x) * plane.zAxis.axis.x + (tri->ys[2] - plane.zAxis.origin.y) * plane.zAxis.axis.y + (tri->zs[2] - plane.zAxis.origin.z) * plane.zAxis.axis.z;
@@ -746,9 +1640,9 @@ int LeRenderer::clip3D(LeTriangle tris[], const int srcIndices[], int dstIndices
 			tri->vd = dx * dx + dy * dy + dz * dz - vOffset;
 			dstIndices[k++] = j;
 		}
-		if (s >= 4 && extra < extraMax) {
+		if (s >= 4 && segment.extra < segment.extraMax) {
 		// Copy triangle coordinates
-			LeTriangle * ntri = &tris[extra];
+			LeTriangle * ntri = &tris[segment.extra];
 			ntri->xs[0] = nx[0];
 			ntri->xs[1] = nx[2];
 			ntri->xs[2] = nx[3];
@@ -776,14 +1670,14 @@ int LeRenderer::clip3D(LeTriangle tris[], const int srcIndices[], int dstIndices
 			ntri->diffuseTexture = tri->diffuseTexture;
 			ntri->flags = tri->flags;
 
-			dstIndices[k++] = extra++;
+			dstIndices[k++] = segment.extra++;
 		}
 	}
 	return k;
 }
 
 /*****************************************************************************/
-int LeRenderer::clip2D(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb, LeAxis &axis)
+int LeRenderer::clip2D(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb, LeAxis &axis, Segment & segment)
 {
 	int k = 0;
 	for (int i = 0; i < nb; i++) {
@@ -865,9 +1759,9 @@ int LeRenderer::clip2D(LeTriangle tris[], const int srcIndices[], int dstIndices
 
 			dstIndices[k++] = j;
 		}
-		if (s >= 4 && extra < extraMax) {
+		if (s >= 4 && segment.extra < segment.extraMax) {
 		// Copy triangle coordinates
-			LeTriangle * ntri = &tris[extra];
+			LeTriangle * ntri = &tris[segment.extra];
 			ntri->xs[0] = nx[0];
 			ntri->xs[1] = nx[2];
 			ntri->xs[2] = nx[3];
@@ -890,7 +1784,7 @@ int LeRenderer::clip2D(LeTriangle tris[], const int srcIndices[], int dstIndices
 			ntri->diffuseTexture = tri->diffuseTexture;
 			ntri->flags = tri->flags;
 
-			dstIndices[k++] = extra++;
+			dstIndices[k++] = segment.extra++;
 		}
 	}
 	return k;
@@ -937,7 +1831,7 @@ int LeRenderer::backculling(LeTriangle tris[], const int srcIndices[], int dstIn
 		for (int i = 0; i < nb; i++) {
 			int j = srcIndices[i];
 			LeTriangle * tri = &tris[j];
-			if (!(tri->flags & LE_TRIANGLE_BLENDED)) {
+			if (!(tri->flags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT))) {
 				float dir;
 				dir = (tri->xs[1] - tri->xs[0]) * (tri->ys[2] - tri->ys[0]);
 				dir -= (tri->ys[1] - tri->ys[0]) * (tri->xs[2] - tri->xs[0]);
@@ -953,7 +1847,7 @@ int LeRenderer::backculling(LeTriangle tris[], const int srcIndices[], int dstIn
 		for (int i = 0; i < nb; i++) {
 			int j = srcIndices[i];
 			LeTriangle * tri = &tris[j];
-			if (!(tri->flags & LE_TRIANGLE_BLENDED)) {
+			if (!(tri->flags & (LE_TRIANGLE_BLENDED | LE_TRIANGLE_CUTOUT))) {
 				float dir;
 				dir = (tri->xs[1] - tri->xs[0]) * (tri->ys[2] - tri->ys[0]);
 				dir -= (tri->ys[1] - tri->ys[0]) * (tri->xs[2] - tri->xs[0]);
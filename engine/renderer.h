@@ -46,10 +46,12 @@
 #include "color.h"
 #include "geometry.h"
 #include "mesh.h"
+#include "meshlod.h"
 #include "bset.h"
 #include "rasterizer.h"
 #include "trilist.h"
 #include "verlist.h"
+#include "threads.h"
 
 /*****************************************************************************/
 /**
@@ -64,6 +66,28 @@ typedef enum {
 	LE_BACKCULLING_CW_ALPHA,		/**< Backculling in clockwise mode, transparent triangles are double sided */
 } LE_BACKCULLING_MODES;
 
+/*****************************************************************************/
+/**
+	\enum LE_CLIPPING_MODES
+	\brief Clipping modes (can be combined)
+*/
+typedef enum {
+	LE_CLIPPING_3DFRUSTRUM = 1,		/**< Clip triangles against the 3D frustrum */
+	LE_CLIPPING_2DFRAME = 2,		/**< Clip projected triangles against the 2D viewport frame */
+	LE_CLIPPING_GUARDBAND = 4,		/**< Clip triangles against a guard band around the viewport (rasterizer scissors the rest) */
+} LE_CLIPPING_MODES;
+
+/*****************************************************************************/
+/**
+	\enum LE_RENDERER_VISIBILITY
+	\brief Visibility of a bounding volume against the view frustrum
+*/
+typedef enum {
+	LE_RENDERER_OUTSIDE = 0,		/**< Volume is fully outside the frustrum */
+	LE_RENDERER_PARTIAL,			/**< Volume intersects the frustrum */
+	LE_RENDERER_INSIDE,				/**< Volume is fully inside the frustrum (no clipping needed) */
+} LE_RENDERER_VISIBILITY;
+
 /*****************************************************************************/
 /**
 	\class LeRenderer
@@ -72,10 +96,27 @@ typedef enum {
 class LeRenderer
 {
 public:
+/** Renderer statistics (accumulated until flush) */
+	typedef struct {
+		int noMeshes;					/**< Number of meshes submitted */
+		int noCulled;					/**< Number of meshes culled by their bounding volume */
+		int noTriangles;				/**< Number of mesh triangles submitted */
+		int noRejected;					/**< Triangles rejected by their outcodes or their face plane */
+		int noAccepted;					/**< Triangles accepted by their outcodes (no clipping) */
+		int noClipped;					/**< Triangles sent to the clipping chain */
+		int noPlaneTests;				/**< Triangles tested against a clipping plane */
+		int noExtra;					/**< Extra triangles created by clipping */
+		int noRendered;					/**< Triangles added to the triangle list */
+		int noDropped;					/**< Meshes dropped (vertex or triangle list full) */
+	} Stats;
+
 	LeRenderer(int width = LE_RESOX_DEFAULT, int height = LE_RESOY_DEFAULT);
 	~LeRenderer();
 
 	void render(const LeMesh * mesh);
+	void render(const LeMesh * const meshes[], int noMeshes);
+	void render(const LeMeshLOD * lod);
+	void renderInstances(const LeMesh * mesh, const LeMatrix matrices[], int count);
 	void render(const LeBSet * bset);
 	void flush();
 
@@ -93,27 +134,79 @@ public:
 	void setViewOffset(float offset);
 
 	void setBackcullingMode(LE_BACKCULLING_MODES mode);
+	void setObjectCulling(bool enable);
+	void setClippingMode(int modes);
+	void setGuardBand(float ratio);
 
 	void setFog(bool enable);
 	void setFogProperties(LeColor color, float near, float far);
 
 	void setMipmapping(bool enable);
 
+	void setThreads(int count);
+	int getThreads();
+
 	void setTriangleList(LeTriList * trilist);
 	LeTriList * getTriangleList();
 
-private:
-	bool checkMemory(int noVertexes, int noTriangles);
+	const Stats & getStats();
 
-	int build(const LeMesh * mesh, LeVertex vertexes[], LeTriangle tris[], int indices[]);
+private:
+/** Triangle list segment written by one geometry thread */
+	typedef struct {
+		LeTriangle * tris;				/**< First triangle of the segment */
+		int * srcIndices;				/**< Segment source indexes (valid triangles) */
+		int * dstIndices;				/**< Segment destination indexes (workspace) */
+		int noAllocated;				/**< Number of triangles in the segment */
+		int noUsed;						/**< Number of used triangles */
+		int noValid;					/**< Number of valid triangles */
+		int extra;						/**< Index of extra triangles (current mesh) */
+		int extraMax;					/**< Maximum number of extra triangles (current mesh) */
+		Stats stats;					/**< Segment statistics */
+	} Segment;
+
+/** Geometry job (one per thread) */
+	typedef struct {
+		const LeMesh * const * meshes;	/**< Meshes to render */
+		const LeMatrix * matrices;		/**< Mesh or instance view matrices */
+		int first;						/**< First mesh, instance, vertex or triangle to process */
+		int nb;							/**< Number of meshes, instances, vertexes or triangles to process */
+		int weight;						/**< Number of triangles to process (segment sizing) */
+		bool inside;					/**< Mesh fully inside the frustrum (no outcodes nor clipping) */
+		LeVerList * verlist;			/**< Vertex workspace */
+		Segment segment;				/**< Triangle list segment */
+	} Job;
+
+	bool checkMemory(const LeVerList * verlist, const Segment & segment, int noVertexes, int noTriangles);
+	void reserveLists(int noJobs, int noVertexes, int noTriangles);
+	int checkBounds(const LeMesh * mesh, const LeMatrix & matrix);
+	float getProjectedRadius(const LeMesh * mesh, const LeMatrix & matrix);
+	void transformSphere(const LeMesh * mesh, const LeMatrix & view, LeVertex & center, float & radius);
+
+	void renderMesh(const LeMesh * mesh, const LeMatrix & matrix);
+
+	void openSegments(int noJobs);
+	void closeSegments(int noJobs);
+	void renderRange(const LeMesh * mesh, const LeMatrix & matrix, const int triFlags[], const LeVerList * verlist, int first, int nb, bool inside, Segment & segment);
+
+	static void vertexJob(void * data, int index);
+	static void triangleJob(void * data, int index);
+	static void batchJob(void * data, int index);
+	static void instanceJob(void * data, int index);
+
+	int build(const LeMesh * mesh, const LeMatrix & matrix, const int triFlags[], const LeVerList * verlist, int first, int nb, bool faceCulling, LeTriangle tris[], int readyIndices[], int clipIndices[], int & noClip, int & clipCodes);
 	int build(const LeBSet * bset, LeVertex vertexes[], LeTriangle tris[], int indices[]);
 
 	void updateFrustrum();
 
+	void transform(const LeMesh * mesh, const LeMatrix & matrix, LeVerList * verlist, int first, int nb, bool inside);
 	void transform(const LeMatrix &matrix, const LeVertex srcVertexes[], LeVertex dstVertexes[], int nb);
+	void transform(const LeMatrix &matrix, const float positions[], int stride, LeVertex dstVertexes[], uint16_t codes[], int nb, bool inside);
+	void outcodes(const LeVertex vertexes[], uint16_t codes[], int nb);
+	void project(const LeVertex vertexes[], const uint16_t codes[], LeVertex projected[], int nb);
 	int project(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb);
-	int clip3D(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb, LePlane &plane);
-	int clip2D(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb, LeAxis &axis);
+	int clip3D(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb, LePlane &plane, int code, Segment & segment);
+	int clip2D(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb, LeAxis &axis, Segment & segment);
 	int backculling(LeTriangle tris[], const int srcIndices[], int dstIndices[], int nb);
 
 	LeVerList intVerlist;				/**< Internal vertex list */
@@ -121,10 +214,13 @@ private:
 	LeVerList * usedVerlist;			/**< Current vertex list in use */
 	LeTriList * usedTrilist;			/**< Current triangle list in use */
 
-	int extra;							/**< Index of extra triangles */
-	int extraMax;						/**< Maximum number of extra triangles */
+	LeThreadPool pool;					/**< Geometry threads */
+	Job * jobs;							/**< Geometry jobs (one per thread) */
+	LeVerList * threadVerlists;			/**< Vertex lists of the additional threads */
+	int noThreads;						/**< Number of geometry threads */
 
-	LeColor * colors;					/**< Color table for triangles */
+	int * instFlags;					/**< Triangle flags of the instanced mesh */
+	int noInstFlags;					/**< Number of allocated triangle flags */
 
 	LeVertex viewPosition;				/**< View position of renderer */
 	LeVertex viewAngle;					/**< View angle of renderer (in degrees) */
@@ -138,6 +234,16 @@ private:
 	LePlane viewTopPlan;					/**< 3D frustrum top clipping plane */
 	LePlane viewBotPlan;					/**< 3D frustrum bot clipping plane */
 
+	LePlane guardLeftPlan;				/**< Guard band left clipping plane */
+	LePlane guardRightPlan;				/**< Guard band right clipping plane */
+	LePlane guardTopPlan;				/**< Guard band top clipping plane */
+	LePlane guardBotPlan;				/**< Guard band bot clipping plane */
+
+	LePlane * clipPlanes[6];			/**< Clipping planes in use (near, far, left, right, top, bottom) */
+	int noClipPlanes;					/**< Number of clipping planes in use */
+	float codePlanes[10][4];			/**< Outcode plane equations (clipping planes, then viewport sides in guard band mode) */
+	int noCodePlanes;					/**< Number of outcode planes in use */
+
 	LeAxis viewLeftAxis;				/**< 2D left clipping axis */
 	LeAxis viewRightAxis;				/**< 2D right clipping axis */
 	LeAxis viewTopAxis;					/**< 2D top clipping axis */
@@ -150,8 +256,13 @@ private:
 	float vOffset;						/**< Distance view offset */
 
 	LE_BACKCULLING_MODES backMode;		/**< Backculling mode */
+	bool objectCullingEnable;			/**< Object space backculling enable state */
 	bool mipmappingEnable;				/**< Mipmapping enable state */
 	bool fogEnable;						/**< Fog enable state */
+	int clipMode;						/**< Clipping modes (combination of LE_CLIPPING_MODES) */
+	float guardRatio;					/**< Guard band size (ratio of the viewport size) */
+
+	Stats stats;						/**< Renderer statistics */
 };
 
 #endif // LE_RENDERER_H
@@ -48,6 +48,10 @@
 	#include "emmintrin.h"
 #endif // LE_USE_SSE2
 
+#if LE_USE_AVX2 == 1
+	#include "immintrin.h"
+#endif // LE_USE_AVX2
+
 #if LE_USE_AMMX == 1
 	#include "ammx/ammx.h"
 #endif // LE_USE_AMMX
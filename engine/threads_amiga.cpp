@@ -0,0 +1,126 @@
+/**
+	\file threads_amiga.cpp
+	\brief LightEngine 3D: Native OS threads and thread pool
+	\brief Amiga OS implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frédéric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+/*****************************************************************************/
+#if defined(AMIGA)
+
+#include "threads.h"
+
+#include "global.h"
+#include "config.h"
+
+/*****************************************************************************/
+LeThreadPool::LeThreadPool() :
+	handle(0),
+	noThreads(1)
+{
+}
+
+LeThreadPool::~LeThreadPool()
+{
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeThreadPool::start(int noThreads)
+	\brief Start the pool worker threads (single processor, jobs run on the calling thread)
+	\param[in] noThreads number of threads (including the calling thread)
+*/
+void LeThreadPool::start(int noThreads)
+{
+}
+
+/**
+	\fn void LeThreadPool::stop()
+	\brief Stop and release the pool worker threads
+*/
+void LeThreadPool::stop()
+{
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeThreadPool::run(Job job, void * data, int noJobs)
+	\brief Run jobs on the pool threads and wait for their completion
+	\param[in] job job function (called with data and the job index)
+	\param[in] data job data
+	\param[in] noJobs number of jobs
+*/
+void LeThreadPool::run(Job job, void * data, int noJobs)
+{
+	for (int i = 0; i < noJobs; i++)
+		job(data, i);
+}
+
+/**
+	\fn void LeThreadPool::runAsync(Job job, void * data, int noJobs)
+	\brief Run jobs (on the calling thread, before returning)
+	\param[in] job job function (called with data and the job index)
+	\param[in] data job data
+	\param[in] noJobs number of jobs
+*/
+void LeThreadPool::runAsync(Job job, void * data, int noJobs)
+{
+	for (int i = 0; i < noJobs; i++)
+		job(data, i);
+}
+
+/**
+	\fn void LeThreadPool::wait()
+	\brief Wait for the completion of the jobs started with runAsync()
+*/
+void LeThreadPool::wait()
+{
+}
+
+/*****************************************************************************/
+/**
+	\fn int LeThreadPool::getNoThreads()
+	\brief Get the number of threads running jobs
+	\return number of threads (including the calling thread)
+*/
+int LeThreadPool::getNoThreads()
+{
+	return noThreads;
+}
+
+/**
+	\fn int LeThreadPool::getNoProcessors()
+	\brief Get the number of processors available
+	\return number of processors
+*/
+int LeThreadPool::getNoProcessors()
+{
+	return 1;
+}
+
+#endif
@@ -0,0 +1,274 @@
+/**
+	\file threads_unix.cpp
+	\brief LightEngine 3D: Native OS threads and thread pool
+	\brief Unix OS implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frédéric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+/*****************************************************************************/
+#if defined(__unix__) || defined(__unix) || \
+    defined(__APPLE__) && defined(__MACH__)
+
+#include "threads.h"
+
+#include "global.h"
+#include "config.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/*****************************************************************************/
+typedef struct {
+	pthread_t * threads;			/**< Worker threads */
+	int noWorkers;					/**< Number of worker threads */
+
+	pthread_mutex_t mutex;			/**< Pool state lock */
+	pthread_cond_t started;			/**< Signaled when new jobs are available */
+	pthread_cond_t finished;		/**< Signaled when all the jobs are done */
+
+	LeThreadPool::Job job;			/**< Current job function */
+	void * data;					/**< Current job data */
+	int noJobs;						/**< Number of jobs to run */
+	int nextJob;					/**< Next job to run */
+	int noDone;						/**< Number of jobs done */
+	int generation;					/**< Incremented on each run */
+	bool quit;						/**< Request the workers to exit */
+} LePoolContext;
+
+static void runJobs(LePoolContext * ctx);
+static void * workerEntry(void * data);
+
+/*****************************************************************************/
+LeThreadPool::LeThreadPool() :
+	handle(0),
+	noThreads(1)
+{
+}
+
+LeThreadPool::~LeThreadPool()
+{
+	stop();
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeThreadPool::start(int noThreads)
+	\brief Start the pool worker threads
+	\param[in] noThreads number of threads (including the calling thread)
+*/
+void LeThreadPool::start(int noThreads)
+{
+	stop();
+	if (noThreads <= 1) return;
+
+	LePoolContext * ctx = new LePoolContext;
+	ctx->threads = new pthread_t[noThreads - 1];
+	ctx->noWorkers = 0;
+	pthread_mutex_init(&ctx->mutex, NULL);
+	pthread_cond_init(&ctx->started, NULL);
+	pthread_cond_init(&ctx->finished, NULL);
+	ctx->job = NULL;
+	ctx->data = NULL;
+	ctx->noJobs = 0;
+	ctx->nextJob = 0;
+	ctx->noDone = 0;
+	ctx->generation = 0;
+	ctx->quit = false;
+
+	for (int i = 0; i < noThreads - 1; i++) {
+		if (pthread_create(&ctx->threads[i], NULL, workerEntry, ctx)) break;
+		ctx->noWorkers++;
+	}
+
+	handle = (LeHandle) ctx;
+	this->noThreads = ctx->noWorkers + 1;
+}
+
+/**
+	\fn void LeThreadPool::stop()
+	\brief Stop and release the pool worker threads
+*/
+void LeThreadPool::stop()
+{
+	LePoolContext * ctx = (LePoolContext *) handle;
+	if (!ctx) return;
+
+	pthread_mutex_lock(&ctx->mutex);
+	ctx->quit = true;
+	pthread_cond_broadcast(&ctx->started);
+	pthread_mutex_unlock(&ctx->mutex);
+
+	for (int i = 0; i < ctx->noWorkers; i++)
+		pthread_join(ctx->threads[i], NULL);
+
+	pthread_cond_destroy(&ctx->finished);
+	pthread_cond_destroy(&ctx->started);
+	pthread_mutex_destroy(&ctx->mutex);
+	delete[] ctx->threads;
+	delete ctx;
+
+	handle = 0;
+	noThreads = 1;
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeThreadPool::run(Job job, void * data, int noJobs)
+	\brief Run jobs on the pool threads and wait for their completion
+	\param[in] job job function (called with data and the job index)
+	\param[in] data job data
+	\param[in] noJobs number of jobs
+*/
+void LeThreadPool::run(Job job, void * data, int noJobs)
+{
+	LePoolContext * ctx = (LePoolContext *) handle;
+	if (!ctx || noJobs <= 1) {
+		for (int i = 0; i < noJobs; i++)
+			job(data, i);
+		return;
+	}
+
+	wait();
+	pthread_mutex_lock(&ctx->mutex);
+	ctx->job = job;
+	ctx->data = data;
+	ctx->noJobs = noJobs;
+	ctx->nextJob = 0;
+	ctx->noDone = 0;
+	ctx->generation++;
+	pthread_cond_broadcast(&ctx->started);
+
+// Contribute then wait for the workers
+	runJobs(ctx);
+	while (ctx->noDone < ctx->noJobs)
+		pthread_cond_wait(&ctx->finished, &ctx->mutex);
+	pthread_mutex_unlock(&ctx->mutex);
+}
+
+/**
+	\fn void LeThreadPool::runAsync(Job job, void * data, int noJobs)
+	\brief Run jobs on the pool worker threads and return immediately
+	\param[in] job job function (called with data and the job index)
+	\param[in] data job data
+	\param[in] noJobs number of jobs
+
+	The calling thread does not contribute: call wait() before
+	touching the job data again. Without worker threads, the jobs
+	run on the calling thread before returning.
+*/
+void LeThreadPool::runAsync(Job job, void * data, int noJobs)
+{
+	LePoolContext * ctx = (LePoolContext *) handle;
+	if (!ctx) {
+		for (int i = 0; i < noJobs; i++)
+			job(data, i);
+		return;
+	}
+
+	wait();
+	pthread_mutex_lock(&ctx->mutex);
+	ctx->job = job;
+	ctx->data = data;
+	ctx->noJobs = noJobs;
+	ctx->nextJob = 0;
+	ctx->noDone = 0;
+	ctx->generation++;
+	pthread_cond_broadcast(&ctx->started);
+	pthread_mutex_unlock(&ctx->mutex);
+}
+
+/**
+	\fn void LeThreadPool::wait()
+	\brief Wait for the completion of the jobs started with runAsync()
+*/
+void LeThreadPool::wait()
+{
+	LePoolContext * ctx = (LePoolContext *) handle;
+	if (!ctx) return;
+
+	pthread_mutex_lock(&ctx->mutex);
+	while (ctx->noDone < ctx->noJobs)
+		pthread_cond_wait(&ctx->finished, &ctx->mutex);
+	pthread_mutex_unlock(&ctx->mutex);
+}
+
+/*****************************************************************************/
+/**
+	\fn int LeThreadPool::getNoThreads()
+	\brief Get the number of threads running jobs
+	\return number of threads (including the calling thread)
+*/
+int LeThreadPool::getNoThreads()
+{
+	return noThreads;
+}
+
+/**
+	\fn int LeThreadPool::getNoProcessors()
+	\brief Get the number of processors available
+	\return number of processors
+*/
+int LeThreadPool::getNoProcessors()
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int) n : 1;
+}
+
+/*****************************************************************************/
+static void runJobs(LePoolContext * ctx)
+{
+// Called with the lock held
+	while (ctx->nextJob < ctx->noJobs) {
+		int index = ctx->nextJob++;
+		pthread_mutex_unlock(&ctx->mutex);
+		ctx->job(ctx->data, index);
+		pthread_mutex_lock(&ctx->mutex);
+		if (++ctx->noDone == ctx->noJobs)
+			pthread_cond_signal(&ctx->finished);
+	}
+}
+
+static void * workerEntry(void * data)
+{
+	LePoolContext * ctx = (LePoolContext *) data;
+	pthread_mutex_lock(&ctx->mutex);
+// Runs started before this thread are not missed
+	int generation = 0;
+	while (true) {
+		while (ctx->generation == generation && !ctx->quit)
+			pthread_cond_wait(&ctx->started, &ctx->mutex);
+		if (ctx->quit) break;
+		generation = ctx->generation;
+		runJobs(ctx);
+	}
+	pthread_mutex_unlock(&ctx->mutex);
+	return NULL;
+}
+
+#endif
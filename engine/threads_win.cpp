@@ -0,0 +1,268 @@
+/**
+	\file threads_win.cpp
+	\brief LightEngine 3D: Native OS threads and thread pool
+	\brief Windows OS implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frédéric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+/*****************************************************************************/
+#if defined(_WIN32)
+
+#include "threads.h"
+
+#include "global.h"
+#include "config.h"
+
+#include <stdlib.h>
+#include <windows.h>
+
+/*****************************************************************************/
+typedef struct {
+	HANDLE * threads;				/**< Worker threads */
+	int noWorkers;					/**< Number of worker threads */
+
+	CRITICAL_SECTION lock;			/**< Pool state lock */
+	HANDLE started;					/**< Semaphore released when new jobs are available */
+	HANDLE finished;				/**< Event set when all the jobs are done */
+
+	LeThreadPool::Job job;			/**< Current job function */
+	void * data;					/**< Current job data */
+	int noJobs;						/**< Number of jobs to run */
+	int nextJob;					/**< Next job to run */
+	int noDone;						/**< Number of jobs done */
+	bool quit;						/**< Request the workers to exit */
+} LePoolContext;
+
+static void runJobs(LePoolContext * ctx);
+static DWORD WINAPI workerEntry(LPVOID data);
+
+/*****************************************************************************/
+LeThreadPool::LeThreadPool() :
+	handle(0),
+	noThreads(1)
+{
+}
+
+LeThreadPool::~LeThreadPool()
+{
+	stop();
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeThreadPool::start(int noThreads)
+	\brief Start the pool worker threads
+	\param[in] noThreads number of threads (including the calling thread)
+*/
+void LeThreadPool::start(int noThreads)
+{
+	stop();
+	if (noThreads <= 1) return;
+
+	LePoolContext * ctx = new LePoolContext;
+	ctx->threads = new HANDLE[noThreads - 1];
+	ctx->noWorkers = 0;
+	InitializeCriticalSection(&ctx->lock);
+	ctx->started = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+	ctx->finished = CreateEvent(NULL, FALSE, FALSE, NULL);
+	ctx->job = NULL;
+	ctx->data = NULL;
+	ctx->noJobs = 0;
+	ctx->nextJob = 0;
+	ctx->noDone = 0;
+	ctx->quit = false;
+
+	for (int i = 0; i < noThreads - 1; i++) {
+		HANDLE thread = CreateThread(NULL, 0, workerEntry, ctx, 0, NULL);
+		if (!thread) break;
+		ctx->threads[ctx->noWorkers++] = thread;
+	}
+
+	handle = (LeHandle) ctx;
+	this->noThreads = ctx->noWorkers + 1;
+}
+
+/**
+	\fn void LeThreadPool::stop()
+	\brief Stop and release the pool worker threads
+*/
+void LeThreadPool::stop()
+{
+	LePoolContext * ctx = (LePoolContext *) handle;
+	if (!ctx) return;
+
+	EnterCriticalSection(&ctx->lock);
+	ctx->quit = true;
+	LeaveCriticalSection(&ctx->lock);
+	ReleaseSemaphore(ctx->started, ctx->noWorkers, NULL);
+
+	for (int i = 0; i < ctx->noWorkers; i++) {
+		WaitForSingleObject(ctx->threads[i], INFINITE);
+		CloseHandle(ctx->threads[i]);
+	}
+
+	CloseHandle(ctx->finished);
+	CloseHandle(ctx->started);
+	DeleteCriticalSection(&ctx->lock);
+	delete[] ctx->threads;
+	delete ctx;
+
+	handle = 0;
+	noThreads = 1;
+}
+
+/*****************************************************************************/
+/**
+	\fn void LeThreadPool::run(Job job, void * data, int noJobs)
+	\brief Run jobs on the pool threads and wait for their completion
+	\param[in] job job function (called with data and the job index)
+	\param[in] data job data
+	\param[in] noJobs number of jobs
+*/
+void LeThreadPool::run(Job job, void * data, int noJobs)
+{
+	LePoolContext * ctx = (LePoolContext *) handle;
+	if (!ctx || noJobs <= 1) {
+		for (int i = 0; i < noJobs; i++)
+			job(data, i);
+		return;
+	}
+
+	wait();
+	EnterCriticalSection(&ctx->lock);
+	ctx->job = job;
+	ctx->data = data;
+	ctx->noJobs = noJobs;
+	ctx->nextJob = 0;
+	ctx->noDone = 0;
+	ResetEvent(ctx->finished);
+	LeaveCriticalSection(&ctx->lock);
+	ReleaseSemaphore(ctx->started, cmmin(noJobs - 1, ctx->noWorkers), NULL);
+
+// Contribute then wait for the workers
+	runJobs(ctx);
+	WaitForSingleObject(ctx->finished, INFINITE);
+}
+
+/**
+	\fn void LeThreadPool::runAsync(Job job, void * data, int noJobs)
+	\brief Run jobs on the pool worker threads and return immediately
+	\param[in] job job function (called with data and the job index)
+	\param[in] data job data
+	\param[in] noJobs number of jobs
+
+	The calling thread does not contribute: call wait() before
+	touching the job data again. Without worker threads, the jobs
+	run on the calling thread before returning.
+*/
+void LeThreadPool::runAsync(Job job, void * data, int noJobs)
+{
+	LePoolContext * ctx = (LePoolContext *) handle;
+	if (!ctx) {
+		for (int i = 0; i < noJobs; i++)
+			job(data, i);
+		return;
+	}
+
+	wait();
+	EnterCriticalSection(&ctx->lock);
+	ctx->job = job;
+	ctx->data = data;
+	ctx->noJobs = noJobs;
+	ctx->nextJob = 0;
+	ctx->noDone = 0;
+	ResetEvent(ctx->finished);
+	LeaveCriticalSection(&ctx->lock);
+	ReleaseSemaphore(ctx->started, cmmin(noJobs, ctx->noWorkers), NULL);
+}
+
+/**
+	\fn void LeThreadPool::wait()
+	\brief Wait for the completion of the jobs started with runAsync()
+*/
+void LeThreadPool::wait()
+{
+	LePoolContext * ctx = (LePoolContext *) handle;
+	if (!ctx) return;
+
+	EnterCriticalSection(&ctx->lock);
+	bool done = ctx->noDone >= ctx->noJobs;
+	LeaveCriticalSection(&ctx->lock);
+	if (!done) WaitForSingleObject(ctx->finished, INFINITE);
+}
+
+/*****************************************************************************/
+/**
+	\fn int LeThreadPool::getNoThreads()
+	\brief Get the number of threads running jobs
+	\return number of threads (including the calling thread)
+*/
+int LeThreadPool::getNoThreads()
+{
+	return noThreads;
+}
+
+/**
+	\fn int LeThreadPool::getNoProcessors()
+	\brief Get the number of processors available
+	\return number of processors
+*/
+int LeThreadPool::getNoProcessors()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+}
+
+/*****************************************************************************/
+static void runJobs(LePoolContext * ctx)
+{
+	EnterCriticalSection(&ctx->lock);
+	while (ctx->nextJob < ctx->noJobs) {
+		int index = ctx->nextJob++;
+		LeaveCriticalSection(&ctx->lock);
+		ctx->job(ctx->data, index);
+		EnterCriticalSection(&ctx->lock);
+		if (++ctx->noDone == ctx->noJobs)
+			SetEvent(ctx->finished);
+	}
+	LeaveCriticalSection(&ctx->lock);
+}
+
+static DWORD WINAPI workerEntry(LPVOID data)
+{
+	LePoolContext * ctx = (LePoolContext *) data;
+	while (true) {
+		WaitForSingleObject(ctx->started, INFINITE);
+		if (ctx->quit) break;
+		runJobs(ctx);
+	}
+	return 0;
+}
+
+#endif
@@ -35,18 +35,33 @@
 #include "global.h"
 #include "config.h"
 
+#include <string.h>
+
 /*****************************************************************************/
 LeTriList::LeTriList() :
 	fog(),
-	srcIndices(NULL), dstIndices(NULL),
-	noAllocated(0), noUsed(0), noValid(0)
+	srcIndices(NULL), dstIndices(NULL), triangles(NULL),
+	noAllocated(0), noUsed(0), noValid(0),
+	noHighWater(0), shrinkFrames(LE_LISTS_SHRINK),
+	noInitial(0), noFrames(0),
+	sortKeys(NULL), sortTmp(NULL),
+	sortMode(LE_TRILIST_SORT_MERGE),
+	sortOrder(NULL), sortMarks(NULL),
+	noOrdered(0), sortStamp(0)
 {
-	allocate(LE_TRILIST_MAX);
+	allocate(LE_TRILIST_INIT);
 }
 
 LeTriList::LeTriList(int noTriangles) :
-	srcIndices(NULL), dstIndices(NULL),
-	noAllocated(0), noUsed(0), noValid(0)
+	fog(),
+	srcIndices(NULL), dstIndices(NULL), triangles(NULL),
+	noAllocated(0), noUsed(0), noValid(0),
+	noHighWater(0), shrinkFrames(LE_LISTS_SHRINK),
+	noInitial(0), noFrames(0),
+	sortKeys(NULL), sortTmp(NULL),
+	sortMode(LE_TRILIST_SORT_MERGE),
+	sortOrder(NULL), sortMarks(NULL),
+	noOrdered(0), sortStamp(0)
 {
 	allocate(noTriangles);
 }
@@ -56,19 +71,94 @@ LeTriList::~LeTriList()
 	if (triangles) delete[] triangles;
 	if (srcIndices) delete[] srcIndices;
 	if (dstIndices) delete[] dstIndices;
+	if (sortKeys) delete[] sortKeys;
+	if (sortTmp) delete[] sortTmp;
+	if (sortOrder) delete[] sortOrder;
+	if (sortMarks) delete[] sortMarks;
 }
 
 /*****************************************************************************/
 /**
 	\fn void LeTriList::allocate(int noTriangles)
-	\brief Allocate memory to hold triangles
-	\param[in] noTriangles maximum number of triangles
+	\brief Allocate memory to hold triangles (the list is emptied)
+	\param[in] noTriangles initial number of triangles
 */
 void LeTriList::allocate(int noTriangles)
 {
-	triangles = new LeTriangle[noTriangles];
-	srcIndices = new int[noTriangles * 3];
-	dstIndices = new int[noTriangles * 3];
+	noUsed = 0;
+	noValid = 0;
+	noHighWater = 0;
+	noFrames = 0;
+	noInitial = noTriangles;
+	resize(noTriangles);
+}
+
+/**
+	\fn bool LeTriList::reserve(int noTriangles)
+	\brief Grow the list to hold a number of triangles (the content is kept)
+	\param[in] noTriangles number of triangles needed
+	\return true if the list can hold the triangles, false if limited by LE_TRILIST_MAX
+*/
+bool LeTriList::reserve(int noTriangles)
+{
+	if (noTriangles <= noAllocated) return true;
+	if (noAllocated >= LE_TRILIST_MAX) return false;
+
+// Grow geometrically (amortized)
+	int size = cmmax(noTriangles, noAllocated * 2);
+	resize(cmmin(size, LE_TRILIST_MAX));
+	return noTriangles <= noAllocated;
+}
+
+/**
+	\fn void LeTriList::flush()
+	\brief Empty the list (shrink it if oversized during a whole period)
+*/
+void LeTriList::flush()
+{
+	noHighWater = cmmax(noHighWater, noUsed);
+	noUsed = 0;
+	noValid = 0;
+
+	if (!shrinkFrames) return;
+	if (++noFrames < shrinkFrames) return;
+
+// Shrink to the period high water mark (with some margin)
+	int size = cmmax(noInitial, noHighWater + (noHighWater >> 1));
+	if (size < noAllocated >> 1) resize(size);
+	noHighWater = 0;
+	noFrames = 0;
+}
+
+/*****************************************************************************/
+void LeTriList::resize(int noTriangles)
+{
+	LeTriangle * newTriangles = new LeTriangle[noTriangles];
+	int * newSrcIndices = new int[noTriangles * 3];
+	int * newDstIndices = new int[noTriangles * 3];
+
+	if (triangles) {
+		memcpy((void *) newTriangles, triangles, noUsed * sizeof(LeTriangle));
+		memcpy(newSrcIndices, srcIndices, noValid * sizeof(int));
+		delete[] triangles;
+		delete[] srcIndices;
+		delete[] dstIndices;
+		delete[] sortKeys;
+		delete[] sortTmp;
+		delete[] sortOrder;
+		delete[] sortMarks;
+	}
+
+	triangles = newTriangles;
+	srcIndices = newSrcIndices;
+	dstIndices = newDstIndices;
+	sortKeys = new SortKey[noTriangles];
+	sortTmp = new SortKey[noTriangles];
+	sortOrder = new int[noTriangles];
+	sortMarks = new int[noTriangles];
+	memset(sortMarks, 0, noTriangles * sizeof(int));
+	noOrdered = 0;
+	sortStamp = 0;
 	noAllocated = noTriangles;
 }
 
@@ -79,42 +169,192 @@ void LeTriList::allocate(int noTriangles)
 void LeTriList::zSort()
 {
 	if (!noValid) return;
-	zMergeSort(srcIndices, dstIndices, noValid);
+
+// Gather the keys (one triangle read each)
+	if (sortMode == LE_TRILIST_SORT_COHERENT) {
+		zSeed();
+	}else{
+		for (int i = 0; i < noValid; i++) {
+			int index = srcIndices[i];
+			sortKeys[i].vd = triangles[index].vd;
+			sortKeys[i].index = index;
+		}
+	}
+
+	SortKey * sorted = sortKeys;
+	if (noValid >= 2) {
+		if (sortMode == LE_TRILIST_SORT_RADIX) sorted = zRadixSort(sortKeys, sortTmp, noValid);
+		else if (sortMode == LE_TRILIST_SORT_COHERENT) {
+			if (!zInsertionSort(sortKeys, noValid, noValid * 4))
+				sorted = zRadixSort(sortKeys, sortTmp, noValid);
+		}
+		else zMergeSort(sortKeys, sortTmp, noValid);
+	}
+
+	for (int i = 0; i < noValid; i++)
+		srcIndices[i] = sorted[i].index;
+
+// Keep the order for the next frame
+	if (sortMode == LE_TRILIST_SORT_COHERENT) {
+		memcpy(sortOrder, srcIndices, noValid * sizeof(int));
+		noOrdered = noValid;
+	}
+}
+
+/**
+	\fn void LeTriList::setSortMode(LE_TRILIST_SORT_MODES mode)
+	\brief Set the triangle sorting strategy
+	\param[in] mode sorting strategy
+*/
+void LeTriList::setSortMode(LE_TRILIST_SORT_MODES mode)
+{
+	sortMode = mode;
+	noOrdered = 0;
 }
 
 /*****************************************************************************/
-void LeTriList::zMergeSort(int indices[], int tmp[], int nb)
+void LeTriList::zMergeSort(SortKey keys[], SortKey tmp[], int nb)
 {
+// Sort the halves in the workspace then merge them back
 	int h1 = nb >> 1;
-	int h2 = nb - h1;
-	if (h1 >= 2) zMergeSort(&indices[0], &tmp[0], h1);
-	if (h2 >= 2) zMergeSort(&indices[h1], &tmp[h1], h2);
+	zMergeSortTo(&keys[0], &tmp[0], h1);
+	zMergeSortTo(&keys[h1], &tmp[h1], nb - h1);
+	zMerge(tmp, h1, nb, keys);
+}
+
+void LeTriList::zMergeSortTo(SortKey keys[], SortKey tmp[], int nb)
+{
+// Sort the halves in place then merge them in the workspace
+	if (nb == 1) {
+		tmp[0] = keys[0];
+		return;
+	}
+	int h1 = nb >> 1;
+	if (h1 >= 2) zMergeSort(&keys[0], &tmp[0], h1);
+	if (nb - h1 >= 2) zMergeSort(&keys[h1], &tmp[h1], nb - h1);
+	zMerge(keys, h1, nb, tmp);
+}
+
+void LeTriList::zMerge(const SortKey src[], int h1, int nb, SortKey dst[])
+{
 	int u = 0;
 	int v = h1;
-	float a = triangles[indices[u]].vd;
-	float b = triangles[indices[v]].vd;
+	float a = src[u].vd;
+	float b = src[v].vd;
 	for (int i = 0; i < nb; i++) {
 		if (a > b) {
-			tmp[i] = indices[u++];
+			dst[i] = src[u++];
 			if (u == h1) {
 				for (i++; i < nb; i++)
-					tmp[i] = indices[v ++];
-				for (int i = 0; i < nb; i++)
-					indices[i] = tmp[i];
+					dst[i] = src[v++];
 				return;
 			}
-			a = triangles[indices[u]].vd;
-
+			a = src[u].vd;
 		}else{
-			tmp[i] = indices[v++];
+			dst[i] = src[v++];
 			if (v == nb) {
 				for (i++; i < nb; i++)
-					tmp[i] = indices[u ++];
-				for (int i = 0; i < nb; i++)
-					indices[i] = tmp[i];
+					dst[i] = src[u++];
 				return;
 			}
-			b = triangles[indices[v]].vd;
+			b = src[v].vd;
+		}
+	}
+}
+
+/*****************************************************************************/
+static inline uint32_t radixKey(float vd)
+{
+// Order the float bit patterns as unsigned integers (then reverse)
+	uint32_t u;
+	memcpy(&u, &vd, sizeof(uint32_t));
+	u = (u & 0x80000000) ? ~u : u | 0x80000000;
+	return ~u;
+}
+
+LeTriList::SortKey * LeTriList::zRadixSort(SortKey keys[], SortKey tmp[], int nb)
+{
+// Count the four digits in a single pass
+	int counts[4][256];
+	memset(counts, 0, sizeof(counts));
+	for (int i = 0; i < nb; i++) {
+		uint32_t k = radixKey(keys[i].vd);
+		counts[0][k & 0xFF]++;
+		counts[1][(k >> 8) & 0xFF]++;
+		counts[2][(k >> 16) & 0xFF]++;
+		counts[3][k >> 24]++;
+	}
+
+// Scatter the keys digit by digit (skip the constant digits)
+	SortKey * src = keys;
+	SortKey * dst = tmp;
+	for (int p = 0; p < 4; p++) {
+		int shift = p * 8;
+		int * c = counts[p];
+		if (c[(radixKey(src[0].vd) >> shift) & 0xFF] == nb) continue;
+
+		int sum = 0;
+		for (int d = 0; d < 256; d++) {
+			int n = c[d];
+			c[d] = sum;
+			sum += n;
+		}
+		for (int i = 0; i < nb; i++) {
+			uint32_t k = radixKey(src[i].vd);
+			dst[c[(k >> shift) & 0xFF]++] = src[i];
+		}
+
+		SortKey * t = src;
+		src = dst;
+		dst = t;
+	}
+	return src;
+}
+
+bool LeTriList::zInsertionSort(SortKey keys[], int nb, int budget)
+{
+// Move the keys backward (give up when too many moves)
+	for (int i = 1; i < nb; i++) {
+		SortKey key = keys[i];
+		int j = i;
+		while (j > 0 && keys[j - 1].vd < key.vd) {
+			keys[j] = keys[j - 1];
+			j--;
 		}
+		keys[j] = key;
+		budget -= i - j;
+		if (budget < 0) return false;
+	}
+	return true;
+}
+
+void LeTriList::zSeed()
+{
+	if (sortStamp >= 0x7FFFFFF0) {
+		memset(sortMarks, 0, noAllocated * sizeof(int));
+		sortStamp = 0;
+	}
+	int valid = sortStamp += 2;
+	int placed = valid + 1;
+	for (int i = 0; i < noValid; i++)
+		sortMarks[srcIndices[i]] = valid;
+
+// Previous frame order first, then the new triangles
+	int n = 0;
+	for (int i = 0; i < noOrdered; i++) {
+		int index = sortOrder[i];
+		if (sortMarks[index] != valid) continue;
+		sortMarks[index] = placed;
+		sortKeys[n].vd = triangles[index].vd;
+		sortKeys[n].index = index;
+		n++;
+	}
+	for (int i = 0; i < noValid; i++) {
+		int index = srcIndices[i];
+		if (sortMarks[index] != valid) continue;
+		sortMarks[index] = placed;
+		sortKeys[n].vd = triangles[index].vd;
+		sortKeys[n].index = index;
+		n++;
 	}
 }
@@ -62,12 +62,24 @@ struct LeFog {
 */
 typedef enum {
 	LE_TRIANGLE_DEFAULT		= 0,	/**< default triangle type */ 
-	LE_TRIANGLE_TEXTURED	= 1,	/**< apply single layer texturing */ 
+	LE_TRIANGLE_TEXTURED	= 1,	/**< apply single layer texturing (solid color otherwise) */ 
 	LE_TRIANGLE_MIPMAPPED	= 2,	/**< apply mipmap filtering */ 
 	LE_TRIANGLE_FOGGED		= 4,	/**< apply per-fragment quadratic fog */
 	LE_TRIANGLE_BLENDED		= 8,	/**< apply alpha blending (for textures with alpha channel) */
+	LE_TRIANGLE_CUTOUT		= 16,	/**< apply alpha testing (for textures with binary alpha channel) */
+	LE_TRIANGLE_CLIPCODES	= 0x3F00,	/**< frustrum planes crossed by the triangle (renderer outcodes << 8) */
 }LE_TRIANGLE_FLAGS;
 
+/**
+	\enum LE_TRILIST_SORT_MODES
+	\brief Triangle sorting strategies (view distance, descending order)
+*/
+typedef enum {
+	LE_TRILIST_SORT_MERGE = 0,		/**< merge sort (default) */
+	LE_TRILIST_SORT_RADIX,			/**< LSD radix sort on the view distance bit pattern */
+	LE_TRILIST_SORT_COHERENT,		/**< insertion sort seeded with the previous frame order (radix sort if too unordered) */
+} LE_TRILIST_SORT_MODES;
+
 /**
 	\class LeTriangle
 	\brief Represent a rasterizable triangle 
@@ -98,8 +110,12 @@ public:
 	~LeTriList();
 
 	void allocate(int noTriangles);
+	bool reserve(int noTriangles);
+	void flush();
 	void zSort();
 
+	void setSortMode(LE_TRILIST_SORT_MODES mode);
+
 	LeFog fog;						/**< associated quadratic fog model */
 
 public:
@@ -111,8 +127,36 @@ public:
 	int noUsed;						/**< number of used triangles */
 	int noValid;					/**< number of valid triangles */
 
+	int noHighWater;				/**< highest number of used triangles (current shrink period) */
+	int shrinkFrames;				/**< number of frames before shrinking an oversized list (0 to never shrink) */
+
 private:
-	void zMergeSort(int indices[], int tmp[], int nb);
+	void resize(int noTriangles);
+
+	int noInitial;					/**< initial number of triangles (shrink limit) */
+	int noFrames;					/**< number of frames in the current shrink period */
+
+/** Compact sort key (the sort never touches the triangles) */
+	typedef struct {
+		float vd;					/**< triangle view distance */
+		int index;					/**< triangle index */
+	} SortKey;
+
+	void zMergeSort(SortKey keys[], SortKey tmp[], int nb);
+	void zMergeSortTo(SortKey keys[], SortKey tmp[], int nb);
+	void zMerge(const SortKey src[], int h1, int nb, SortKey dst[]);
+	SortKey * zRadixSort(SortKey keys[], SortKey tmp[], int nb);
+	bool zInsertionSort(SortKey keys[], int nb, int budget);
+	void zSeed();
+
+	SortKey * sortKeys;				/**< array of sort keys */
+	SortKey * sortTmp;				/**< array of sort keys (merge workspace) */
+
+	LE_TRILIST_SORT_MODES sortMode;	/**< triangle sorting strategy */
+	int * sortOrder;				/**< previous frame sorted indexes (coherent sort) */
+	int * sortMarks;				/**< triangle marks (coherent sort) */
+	int noOrdered;					/**< number of previous frame sorted indexes */
+	int sortStamp;					/**< current mark stamp */
 };
 
 #endif // LE_TRILIST_H
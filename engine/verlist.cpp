@@ -37,13 +37,19 @@
 
 /*****************************************************************************/
 LeVerList::LeVerList() :
-	noAllocated(0), noUsed(0)
+	vertexes(NULL), projected(NULL), codes(NULL),
+	noAllocated(0), noUsed(0),
+	noHighWater(0), shrinkFrames(LE_LISTS_SHRINK),
+	noInitial(0), noFrames(0)
 {
-	allocate(LE_VERLIST_MAX);
+	allocate(LE_VERLIST_INIT);
 }
 
 LeVerList::LeVerList(int noVertexes) :
-	noAllocated(0), noUsed(0)
+	vertexes(NULL), projected(NULL), codes(NULL),
+	noAllocated(0), noUsed(0),
+	noHighWater(0), shrinkFrames(LE_LISTS_SHRINK),
+	noInitial(0), noFrames(0)
 {
 	allocate(noVertexes);
 }
@@ -51,16 +57,67 @@ LeVerList::LeVerList(int noVertexes) :
 LeVerList::~LeVerList()
 {
 	if (vertexes) delete[] vertexes;
+	if (projected) delete[] projected;
+	if (codes) delete[] codes;
 }
 
 /*****************************************************************************/
 /**
 	\fn void LeVerList::allocate(int noVertexes)
 	\brief Allocate memory to hold vertexes
-	\param[in] noVertexes maximum number of vertexes
+	\param[in] noVertexes initial number of vertexes
 */
 void LeVerList::allocate(int noVertexes)
 {
+	noUsed = 0;
+	noHighWater = 0;
+	noFrames = 0;
+	noInitial = noVertexes;
+	resize(noVertexes);
+}
+
+/**
+	\fn bool LeVerList::reserve(int noVertexes)
+	\brief Grow the list to hold a number of vertexes (the content is lost)
+	\param[in] noVertexes number of vertexes needed
+	\return true if the list can hold the vertexes, false if limited by LE_VERLIST_MAX
+*/
+bool LeVerList::reserve(int noVertexes)
+{
+	noHighWater = cmmax(noHighWater, noVertexes);
+	if (noVertexes <= noAllocated) return true;
+	if (noAllocated >= LE_VERLIST_MAX) return false;
+
+// Grow geometrically (amortized)
+	int size = cmmax(noVertexes, noAllocated * 2);
+	resize(cmmin(size, LE_VERLIST_MAX));
+	return noVertexes <= noAllocated;
+}
+
+/**
+	\fn void LeVerList::flush()
+	\brief End a frame (shrink the list if oversized during a whole period)
+*/
+void LeVerList::flush()
+{
+	if (!shrinkFrames) return;
+	if (++noFrames < shrinkFrames) return;
+
+// Shrink to the period high water mark (with some margin)
+	int size = cmmax(noInitial, noHighWater + (noHighWater >> 1));
+	if (size < noAllocated >> 1) resize(size);
+	noHighWater = 0;
+	noFrames = 0;
+}
+
+/*****************************************************************************/
+void LeVerList::resize(int noVertexes)
+{
+	if (vertexes) delete[] vertexes;
+	if (projected) delete[] projected;
+	if (codes) delete[] codes;
 	vertexes = new LeVertex[noVertexes];
+	projected = new LeVertex[noVertexes];
+	codes = new uint16_t[noVertexes];
 	noAllocated = noVertexes;
 }
@@ -38,6 +38,25 @@
 
 #include "geometry.h"
 
+/*****************************************************************************/
+/**
+	\enum LE_VERLIST_CODES
+	\brief Vertex clipping outcodes (set when outside a frustrum plane)
+*/
+typedef enum {
+	LE_VERLIST_CODE_NEAR	= 1,		/**< Vertex is in front of the near plane */
+	LE_VERLIST_CODE_FAR		= 2,		/**< Vertex is behind the far plane */
+	LE_VERLIST_CODE_LEFT	= 4,		/**< Vertex is outside the left plane */
+	LE_VERLIST_CODE_RIGHT	= 8,		/**< Vertex is outside the right plane */
+	LE_VERLIST_CODE_TOP		= 16,		/**< Vertex is outside the top plane */
+	LE_VERLIST_CODE_BOTTOM	= 32,		/**< Vertex is outside the bottom plane */
+	LE_VERLIST_CODE_CLIP	= 63,		/**< Planes the triangles are clipped against (guard band sides in guard band mode) */
+	LE_VERLIST_CODE_VIEW_LEFT	= 64,	/**< Vertex is outside the viewport left plane (guard band mode) */
+	LE_VERLIST_CODE_VIEW_RIGHT	= 128,	/**< Vertex is outside the viewport right plane (guard band mode) */
+	LE_VERLIST_CODE_VIEW_TOP	= 256,	/**< Vertex is outside the viewport top plane (guard band mode) */
+	LE_VERLIST_CODE_VIEW_BOTTOM	= 512,	/**< Vertex is outside the viewport bottom plane (guard band mode) */
+} LE_VERLIST_CODES;
+
 /*****************************************************************************/
 /**
 	\class LeVerList
@@ -51,12 +70,25 @@ public:
 	~LeVerList();
 
 	void allocate(int noVertexes);
+	bool reserve(int noVertexes);
+	void flush();
 
 public:
 	LeVertex * vertexes;				/**< array of vertexes */
+	LeVertex * projected;				/**< array of projected vertexes (x, y on viewport, w in z) */
+	uint16_t * codes;					/**< array of vertex clipping outcodes */
 
 	int noAllocated;					/**< number of allocated vertexes */
 	int noUsed;							/**< number of used vertexes */
+
+	int noHighWater;					/**< highest number of reserved vertexes (current shrink period) */
+	int shrinkFrames;					/**< number of frames before shrinking an oversized list (0 to never shrink) */
+
+private:
+	void resize(int noVertexes);
+
+	int noInitial;						/**< initial number of vertexes (shrink limit) */
+	int noFrames;						/**< number of frames in the current shrink period */
 };
 
 #endif // LE_VERLIST_H
@@ -0,0 +1,110 @@
+/**
+	\file benchmark.cpp
+	\brief LightEngine 3D (examples): headless rendering benchmark
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+*/
+
+#include "engine/le3d.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+/*****************************************************************************/
+const int benchFrames = 200;
+
+typedef struct {
+	const char * name;
+	int mode;
+} BenchMode;
+
+const BenchMode benchModes[] = {
+	{"3D frustrum", LE_CLIPPING_3DFRUSTRUM},
+	{"2D frame", LE_CLIPPING_2DFRAME},
+	{"Guard band", LE_CLIPPING_GUARDBAND},
+};
+const int noBenchModes = sizeof(benchModes) / sizeof(BenchMode);
+
+/*****************************************************************************/
+int main(int argc, char * argv[])
+{
+	const char * path = argc > 1 ? argv[1] : "../destroyer/assets";
+	int threads = argc > 2 ? atoi(argv[2]) : 1;
+	int rasterThreads = argc > 3 ? atoi(argv[3]) : 1;
+
+/** Create application objects (no window) */
+	LeRenderer	 renderer	= LeRenderer();
+	LeRasterizer rasterizer = LeRasterizer();
+	renderer.setThreads(threads);
+	rasterizer.setThreads(rasterThreads);
+
+/** Load the assets (textures then 3D models) */
+	bmpCache.loadDirectory(path);
+	meshCache.loadDirectory(path);
+
+	LeMesh * skybox = meshCache.getMeshFromName("skybox.obj");
+	LeMesh * destroyer = meshCache.getMeshFromName("destroyer.obj");
+	LeMesh * launcher = meshCache.getMeshFromName("launcher.obj");
+	if (!skybox || !destroyer || !launcher) {
+		printf("benchmark: assets not found in %s\n", path);
+		return 1;
+	}
+	skybox->scale = LeVertex(100.0f, 100.0f, 100.0f);
+	skybox->updateMatrix();
+
+/** Run each clipping mode over the same camera path */
+	printf("geometry threads: %i\n", renderer.getThreads());
+	printf("rasterizer threads: %i\n", rasterizer.getThreads());
+	const char * backendNames[] = {"auto", "ref", "sse2", "avx2", "ammx"};
+	printf("rasterizer backend: %s\n", backendNames[rasterizer.getBackend()]);
+	printf("%-12s %10s %10s %10s %10s %10s\n", "mode", "ms/frame", "render", "raster", "clipped", "extra");
+	for (int m = 0; m < noBenchModes; m++) {
+		renderer.setClippingMode(benchModes[m].mode);
+
+		clock_t renderTime = 0;
+		clock_t rasterTime = 0;
+		int noClipped = 0;
+		int noExtra = 0;
+
+		for (int f = 0; f < benchFrames; f++) {
+			float t = f * 0.05f;
+			renderer.setViewPosition(LeVertex(sinf(t) * 30.0f, 5.0f, 40.0f + cosf(t) * 30.0f));
+			renderer.setViewAngle(LeVertex(0.0f, t * 40.0f, 0.0f));
+			renderer.updateViewMatrix();
+
+			clock_t c0 = clock();
+			renderer.render(skybox);
+			renderer.render(destroyer);
+			for (int i = 0; i < 8; i++) {
+				launcher->pos = LeVertex(i * 12.0f - 42.0f, 0.0f, -20.0f);
+				launcher->angle = LeVertex(0.0f, t * 50.0f + i * 45.0f, 0.0f);
+				launcher->updateMatrix();
+				renderer.render(launcher);
+			}
+
+			clock_t c1 = clock();
+			rasterizer.flush();
+			rasterizer.rasterList(renderer.getTriangleList());
+			clock_t c2 = clock();
+
+			const LeRenderer::Stats & stats = renderer.getStats();
+			noClipped += stats.noClipped;
+			noExtra += stats.noExtra;
+			renderer.flush();
+
+			renderTime += c1 - c0;
+			rasterTime += c2 - c1;
+		}
+
+		float ms = 1000.0f / (CLOCKS_PER_SEC * benchFrames);
+		printf("%-12s %10.3f %10.3f %10.3f %10d %10d\n", benchModes[m].name,
+			(renderTime + rasterTime) * ms, renderTime * ms, rasterTime * ms,
+			noClipped / benchFrames, noExtra / benchFrames);
+	}
+
+	return 0;
+}
@@ -716,7 +716,8 @@ void launchersUpdate()
 
 void launchersRender(LeRenderer & renderer)
 {
-	renderer.setViewOffset(50.0f);
+	LeMatrix matrices[launchersNb];
+	int count = 0;
 	for (int l = 0; l < launchersNb; l++) {
 		if (!launchers[l].life) continue;
 		launcherMesh->pos = launchersPos[l];
@@ -725,8 +726,11 @@ void launchersRender(LeRenderer & renderer)
 		else launcherMesh->angle.x = 180.0f;
 		
 		launcherMesh->updateMatrix();
-		renderer.render(launcherMesh);
+		matrices[count++] = launcherMesh->view;
 	}
+
+	renderer.setViewOffset(50.0f);
+	renderer.renderInstances(launcherMesh, matrices, count);
 	renderer.setViewOffset(0.0f);
 }
 
@@ -0,0 +1,64 @@
+/**
+	\file lodgen.cpp
+	\brief LightEngine 3D (examples): offline mesh LOD chain generator
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+*/
+
+#include "engine/le3d.h"
+#include "tools/simplifier.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/*****************************************************************************/
+int main(int argc, char * argv[])
+{
+	if (argc < 2) {
+		printf("usage: lodgen file.obj [levels] [ratio]\n");
+		return 1;
+	}
+	const char * path = argv[1];
+	int noLevels = argc > 2 ? atoi(argv[2]) : 4;
+	float ratio = argc > 3 ? (float) atof(argv[3]) : 0.5f;
+
+/** Load the textures (for the material names) then the mesh */
+	char dir[LE_MAX_FILE_PATH+1];
+	LeGlobal::getFileDirectory(dir, LE_MAX_FILE_PATH, path);
+	bmpCache.loadDirectory(dir);
+
+	LeObjFile objFile = LeObjFile(path);
+	LeMesh * mesh = objFile.load(0);
+	if (!mesh) {
+		printf("lodgen: cannot load %s\n", path);
+		return 1;
+	}
+
+/** Generate and save the levels (name_lodN.obj) */
+	LeSimplifier simplifier;
+	LeMeshLOD lod;
+	LeMesh * levels[LE_MESHLOD_MAX_LEVELS];
+	int n = simplifier.generate(mesh, &lod, levels, noLevels, ratio, 64.0f);
+
+	char base[LE_MAX_FILE_PATH+1];
+	strncpy(base, path, LE_MAX_FILE_PATH);
+	base[LE_MAX_FILE_PATH] = '\0';
+	char * ext = strrchr(base, '.');
+	if (ext) *ext = '\0';
+
+	printf("level %i: %i triangles\n", 0, mesh->noTriangles);
+	for (int i = 1; i < n; i++) {
+		char levelPath[LE_MAX_FILE_PATH+16];
+		snprintf(levelPath, sizeof(levelPath), "%s_lod%i.obj", base, i);
+		LeObjFile levelFile = LeObjFile(levelPath);
+		levelFile.save(levels[i]);
+		printf("level %i: %i triangles, switch below %.1f pixels (%s)\n", i, levels[i]->noTriangles, lod.sizes[i - 1], levelPath);
+		delete levels[i];
+	}
+
+	delete mesh;
+	return 0;
+}
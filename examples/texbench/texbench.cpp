@@ -0,0 +1,234 @@
+/**
+	\file texbench.cpp
+	\brief LightEngine 3D (examples): texture layout benchmark (row ordered vs tiled)
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+*/
+
+#include "engine/le3d.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <string.h>
+
+#if defined(__linux__)
+	#include <linux/perf_event.h>
+	#include <sys/syscall.h>
+	#include <sys/ioctl.h>
+	#include <unistd.h>
+#endif
+
+/*****************************************************************************/
+const int benchFrames = 50;
+const float benchAngles[] = {0.0f, 30.0f, 60.0f, 90.0f};
+const int noBenchAngles = sizeof(benchAngles) / sizeof(float);
+
+/** Simulated first level data cache (32 KiB, 8 ways, 64 bytes lines) */
+const int cacheWays = 8;
+const int cacheSets = 64;
+const int cacheLine = 64;
+
+/*****************************************************************************/
+/** Hardware first level data cache read misses (Linux only) */
+class MissCounter
+{
+public:
+	MissCounter() : fd(-1)
+	{
+	#if defined(__linux__)
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	#endif
+	}
+
+	~MissCounter()
+	{
+	#if defined(__linux__)
+		if (fd >= 0) close(fd);
+	#endif
+	}
+
+	bool available() {return fd >= 0;}
+
+	void start()
+	{
+	#if defined(__linux__)
+		if (fd < 0) return;
+		ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+	#endif
+	}
+
+	int64_t stop()
+	{
+		int64_t count = 0;
+	#if defined(__linux__)
+		if (fd < 0) return 0;
+		ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(fd, &count, sizeof(count)) != sizeof(count)) count = 0;
+	#endif
+		return count;
+	}
+
+private:
+	int fd;
+};
+
+/*****************************************************************************/
+/** Texel fetches of a rotated 1:1 mapping through a LRU cache model */
+float simulateMisses(float angle, int sx, int sy, int tp2, bool tiled)
+{
+	uint32_t tags[cacheSets][cacheWays];
+	uint32_t ages[cacheSets][cacheWays];
+	memset(tags, 0xFF, sizeof(tags));
+	memset(ages, 0, sizeof(ages));
+
+	int mask = (1 << tp2) - 1;
+	float ca = cosf(angle * d2r);
+	float sa = sinf(angle * d2r);
+	uint32_t clock = 0;
+	int64_t misses = 0;
+
+	for (int y = 0; y < sy; y++) {
+		for (int x = 0; x < sx; x++) {
+			float px = x - sx * 0.5f;
+			float py = y - sy * 0.5f;
+			int u = ((int) floorf(px * ca + py * sa)) & mask;
+			int v = ((int) floorf(py * ca - px * sa)) & mask;
+
+		// Same layout as LeBitmap::tile()
+			uint32_t i = u + (v << tp2);
+			if (tiled) i = (u & 3) + ((u & ~3) << 2) + ((v & 3) << 2) + ((v & ~3) << tp2);
+
+			uint32_t line = i * sizeof(LeColor) / cacheLine;
+			uint32_t * t = tags[line % cacheSets];
+			uint32_t * a = ages[line % cacheSets];
+			int w = 0;
+			while (w < cacheWays && t[w] != line) w++;
+			if (w == cacheWays) {
+				w = 0;
+				for (int k = 1; k < cacheWays; k++)
+					if (a[k] < a[w]) w = k;
+				t[w] = line;
+				misses++;
+			}
+			a[w] = ++clock;
+		}
+	}
+	return (float) misses / (sx * sy);
+}
+
+/*****************************************************************************/
+/** Load a texture and return its cache slot */
+int loadTexture(const char * path, bool tiled)
+{
+	bmpCache.setTiling(tiled);
+	LeBitmap * bmp = bmpCache.loadBMP(path);
+	bmpCache.setTiling(false);
+	if (!bmp) return -1;
+
+	for (int i = 0; i < LE_BMPCACHE_SLOTS; i++)
+		if (bmpCache.cacheSlots[i].bitmap == bmp) return i;
+	return -1;
+}
+
+/*****************************************************************************/
+int main(int argc, char * argv[])
+{
+	const char * path = argc > 1 ? argv[1] : "../destroyer/assets/skytest.bmp";
+
+/** Create application objects (no window) */
+	LeRenderer	 renderer	= LeRenderer();
+	LeRasterizer rasterizer = LeRasterizer();
+	renderer.setBackcullingMode(LE_BACKCULLING_NONE);
+
+/** Load the texture twice (row ordered and tiled) */
+	int slots[2];
+	slots[0] = loadTexture(path, false);
+	slots[1] = loadTexture(path, true);
+	if (slots[0] < 0 || slots[1] < 0) {
+		printf("texbench: cannot load %s\n", path);
+		return 1;
+	}
+	LeBitmap * bmp = bmpCache.cacheSlots[slots[1]].bitmap;
+	if (!(bmp->flags & LE_BITMAP_TILED))
+		printf("texbench: tiled textures not supported (build with LE3D_TEXTURE_TILING and power of 2 textures)\n");
+
+/** Build a quad covering the frame whatever its angle (about one texel per pixel) */
+	int sx = rasterizer.frame.tx;
+	int sy = rasterizer.frame.ty;
+	float ppu = sx / tanf(LE_RENDERER_FOV_DEFAULT * d2r);
+	float s = sqrtf((float) (sx * sx + sy * sy)) * 0.5f / ppu;
+	float r = 2.0f * s * ppu / bmp->tx;
+
+	LeMesh quad;
+	quad.allocate(4, 4, 2);
+	quad.vertexes[0] = LeVertex(-s, -s, 0.0f);
+	quad.vertexes[1] = LeVertex(s, -s, 0.0f);
+	quad.vertexes[2] = LeVertex(s, s, 0.0f);
+	quad.vertexes[3] = LeVertex(-s, s, 0.0f);
+	const float texCoords[8] = {0.0f, r, r, r, r, 0.0f, 0.0f, 0.0f};
+	const int indexes[6] = {0, 1, 2, 0, 2, 3};
+	memcpy(quad.texCoords, texCoords, sizeof(texCoords));
+	memcpy(quad.vertexesList, indexes, sizeof(indexes));
+	memcpy(quad.texCoordsList, indexes, sizeof(indexes));
+	quad.computeBounds();
+	quad.computePositions();
+	quad.computePlanes();
+
+	renderer.setViewPosition(LeVertex(0.0f, 0.0f, 1.0f));
+	renderer.updateViewMatrix();
+
+/** Render the quad rolled at each angle with both layouts */
+	MissCounter counter;
+	printf("texture: %s (%ix%i)\n", path, bmp->tx, bmp->ty);
+	printf("simulated cache: %i KiB, %i ways, %i bytes lines\n", cacheSets * cacheWays * cacheLine / 1024, cacheWays, cacheLine);
+	printf("%-8s %10s %10s %12s %12s %12s %12s\n", "angle", "rows ms", "tiles ms", "rows sim", "tiles sim", "rows L1D", "tiles L1D");
+	for (int a = 0; a < noBenchAngles; a++) {
+		quad.angle = LeVertex(0.0f, 0.0f, benchAngles[a]);
+		quad.updateMatrix();
+
+		float ms[2];
+		float hw[2];
+		for (int l = 0; l < 2; l++) {
+			for (int t = 0; t < quad.noTriangles; t++)
+				quad.texSlotList[t] = slots[l];
+			renderer.render(&quad);
+
+			clock_t rasterTime = 0;
+			int64_t misses = 0;
+			for (int f = 0; f < benchFrames; f++) {
+				clock_t c0 = clock();
+				counter.start();
+				rasterizer.rasterList(renderer.getTriangleList());
+				misses += counter.stop();
+				rasterTime += clock() - c0;
+			}
+			renderer.flush();
+
+			ms[l] = rasterTime * 1000.0f / (CLOCKS_PER_SEC * benchFrames);
+			hw[l] = (float) misses / ((float) sx * sy * benchFrames);
+		}
+
+		float sim[2];
+		sim[0] = simulateMisses(benchAngles[a], sx, sy, bmp->txP2, false);
+		sim[1] = simulateMisses(benchAngles[a], sx, sy, bmp->txP2, true);
+
+		printf("%-8.0f %10.3f %10.3f %12.4f %12.4f", benchAngles[a], ms[0], ms[1], sim[0], sim[1]);
+		if (counter.available()) printf(" %12.4f %12.4f\n", hw[0], hw[1]);
+		else printf(" %12s %12s\n", "n/a", "n/a");
+	}
+
+	return 0;
+}
@@ -0,0 +1,569 @@
+/**
+	\file simplifier.cpp
+	\brief LightEngine 3D (tools): Quadric error mesh simplifier
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "simplifier.h"
+
+#include "../engine/le3d.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+/*****************************************************************************/
+// Vertex kinds
+#define LE_SIMPLIFIER_BORDER		1		/**< Vertex on an open border */
+#define LE_SIMPLIFIER_SEAM			2		/**< Vertex on a texture coordinates or slot seam */
+#define LE_SIMPLIFIER_LOCKED		4		/**< Vertex on a non manifold edge */
+
+#define LE_SIMPLIFIER_MAX_MAP		8		/**< Maximum number of texture coordinates around a vertex */
+
+/*****************************************************************************/
+LeSimplifier::LeSimplifier() :
+	maxError(FLT_MAX),
+	borderWeight(10.0f),
+	error(0.0f),
+	vertexes(NULL), quadrics(NULL),
+	kinds(NULL), marks(NULL), locks(NULL),
+	noVertexes(0),
+	tris(NULL), texs(NULL), slots(NULL), removed(NULL),
+	noTriangles(0), noLive(0),
+	adjStart(NULL), adjTris(NULL),
+	collapses(NULL),
+	stamp(0), pass(0)
+{
+}
+
+LeSimplifier::~LeSimplifier()
+{
+	deallocate();
+}
+
+/*****************************************************************************/
+/**
+	\fn LeMesh * LeSimplifier::simplify(const LeMesh * mesh, int target)
+	\brief Create a simplified copy of a mesh
+	\param[in] mesh pointer to the source mesh
+	\param[in] target number of triangles to reach
+	\return pointer to a new mesh (owned by the caller), NULL if the mesh is empty
+*/
+LeMesh * LeSimplifier::simplify(const LeMesh * mesh, int target)
+{
+	if (!mesh->vertexes || !mesh->vertexesList || !mesh->noTriangles) return NULL;
+	allocate(mesh);
+	computeQuadrics();
+	error = 0.0f;
+
+	int map[LE_SIMPLIFIER_MAX_MAP][3];
+	while (noLive > target) {
+	// List the collapses of every edge (both directions)
+		computeAdjacency();
+		int noCollapses = 0;
+		for (int t = 0; t < noTriangles; t++) {
+			if (removed[t]) continue;
+			for (int k = 0; k < 3; k++) {
+				int a = tris[t * 3 + k];
+				int b = tris[t * 3 + (k + 1) % 3];
+				for (int d = 0; d < 2; d++) {
+					int from = d ? b : a;
+					int to = d ? a : b;
+					if (kinds[from] & LE_SIMPLIFIER_LOCKED) continue;
+					if ((kinds[from] & LE_SIMPLIFIER_BORDER) && !(kinds[to] & LE_SIMPLIFIER_BORDER)) continue;
+					if ((kinds[from] & LE_SIMPLIFIER_SEAM) && !(kinds[to] & LE_SIMPLIFIER_SEAM)) continue;
+					double cost = evaluate(quadrics[from], vertexes[to]) + evaluate(quadrics[to], vertexes[to]);
+					if (cost > maxError) continue;
+					Collapse * c = &collapses[noCollapses++];
+					c->from = from;
+					c->to = to;
+					c->cost = (float) cost;
+				}
+			}
+		}
+
+	// Collapse the cheapest independant edges
+		qsort(collapses, noCollapses, sizeof(Collapse), compareCollapses);
+		pass++;
+		int noDone = 0;
+		for (int i = 0; i < noCollapses && noLive > target; i++) {
+			Collapse * c = &collapses[i];
+			if (locks[c->from] == pass || locks[c->to] == pass) continue;
+			int noMap = 0;
+			if (!check(c->from, c->to, map, noMap)) continue;
+			collapse(c->from, c->to, map, noMap);
+			error = cmmax(error, c->cost);
+			noDone++;
+		}
+		if (!noDone) break;
+	}
+
+	LeMesh * result = extract(mesh);
+	deallocate();
+	return result;
+}
+
+/**
+	\fn int LeSimplifier::generate(LeMesh * mesh, LeMeshLOD * lod, LeMesh * levels[], int noLevels, float ratio, float size)
+	\brief Generate a LOD chain from a mesh (each level keeps a ratio of the previous level triangles)
+	\param[in] mesh pointer to the source mesh (first level)
+	\param[out] lod pointer to the LOD chain to fill
+	\param[out] levels level meshes (the generated ones are owned by the caller)
+	\param[in] noLevels maximum number of levels
+	\param[in] ratio triangle ratio between two levels
+	\param[in] size projected radius to switch from the first level (in pixels)
+	\return number of levels generated
+*/
+int LeSimplifier::generate(LeMesh * mesh, LeMeshLOD * lod, LeMesh * levels[], int noLevels, float ratio, float size)
+{
+	lod->clear();
+	noLevels = cmmin(noLevels, LE_MESHLOD_MAX_LEVELS);
+	if (noLevels < 1) return 0;
+
+// Simplify from the source mesh for each level
+	levels[0] = mesh;
+	int n = 1;
+	float keep = 1.0f;
+	for (int i = 1; i < noLevels; i++) {
+		keep *= ratio;
+		LeMesh * level = simplify(mesh, (int) (mesh->noTriangles * keep));
+		if (!level) break;
+		if (level->noTriangles >= levels[n - 1]->noTriangles) {
+			delete level;
+			break;
+		}
+		levels[n++] = level;
+	}
+
+// Keep the projected triangle density (the last level is never culled)
+	float scale = sqrtf(ratio);
+	for (int i = 0; i < n; i++) {
+		lod->addLevel(levels[i], i == n - 1 ? 0.0f : size);
+		size *= scale;
+	}
+	return n;
+}
+
+/*****************************************************************************/
+void LeSimplifier::allocate(const LeMesh * mesh)
+{
+	deallocate();
+
+	noVertexes = mesh->noVertexes;
+	vertexes = new LeVertex[noVertexes];
+	memcpy(vertexes, mesh->vertexes, noVertexes * sizeof(LeVertex));
+	quadrics = new Quadric[noVertexes];
+	memset(quadrics, 0, noVertexes * sizeof(Quadric));
+	kinds = new uint8_t[noVertexes];
+	memset(kinds, 0, noVertexes * sizeof(uint8_t));
+	marks = new int[noVertexes];
+	memset(marks, 0, noVertexes * sizeof(int));
+	locks = new int[noVertexes];
+	memset(locks, 0, noVertexes * sizeof(int));
+
+	noTriangles = mesh->noTriangles;
+	tris = new int[noTriangles * 3];
+	memcpy(tris, mesh->vertexesList, noTriangles * 3 * sizeof(int));
+	texs = new int[noTriangles * 3];
+	if (mesh->texCoordsList) memcpy(texs, mesh->texCoordsList, noTriangles * 3 * sizeof(int));
+	else memset(texs, 0, noTriangles * 3 * sizeof(int));
+	slots = new int[noTriangles];
+	if (mesh->texSlotList) memcpy(slots, mesh->texSlotList, noTriangles * sizeof(int));
+	else memset(slots, 0, noTriangles * sizeof(int));
+
+// Drop the degenerated triangles
+	removed = new uint8_t[noTriangles];
+	noLive = 0;
+	for (int t = 0; t < noTriangles; t++) {
+		int * v = &tris[t * 3];
+		removed[t] = v[0] == v[1] || v[1] == v[2] || v[2] == v[0];
+		if (!removed[t]) noLive++;
+	}
+
+	adjStart = new int[noVertexes + 1];
+	adjTris = new int[noTriangles * 3];
+	collapses = new Collapse[noTriangles * 6];
+	stamp = 0;
+	pass = 0;
+}
+
+void LeSimplifier::deallocate()
+{
+	if (vertexes) delete[] vertexes;
+	vertexes = NULL;
+	if (quadrics) delete[] quadrics;
+	quadrics = NULL;
+	if (kinds) delete[] kinds;
+	kinds = NULL;
+	if (marks) delete[] marks;
+	marks = NULL;
+	if (locks) delete[] locks;
+	locks = NULL;
+	noVertexes = 0;
+
+	if (tris) delete[] tris;
+	tris = NULL;
+	if (texs) delete[] texs;
+	texs = NULL;
+	if (slots) delete[] slots;
+	slots = NULL;
+	if (removed) delete[] removed;
+	removed = NULL;
+	noTriangles = 0;
+	noLive = 0;
+
+	if (adjStart) delete[] adjStart;
+	adjStart = NULL;
+	if (adjTris) delete[] adjTris;
+	adjTris = NULL;
+	if (collapses) delete[] collapses;
+	collapses = NULL;
+}
+
+/*****************************************************************************/
+void LeSimplifier::computeQuadrics()
+{
+// Accumulate the face planes (weighted by area)
+	for (int t = 0; t < noTriangles; t++) {
+		if (removed[t]) continue;
+		LeVertex n = faceNormal(t);
+		float area = n.w * 0.5f;
+		if (area == 0.0f) continue;
+		float d = -n.dot(vertexes[tris[t * 3]]);
+		for (int k = 0; k < 3; k++)
+			addPlane(quadrics[tris[t * 3 + k]], n, d, area);
+	}
+
+// Sort the triangle edges (vertex pair, triangle, start vertex)
+	int * edges = new int[noTriangles * 3 * 4];
+	int noEdges = 0;
+	for (int t = 0; t < noTriangles; t++) {
+		if (removed[t]) continue;
+		for (int k = 0; k < 3; k++) {
+			int a = tris[t * 3 + k];
+			int b = tris[t * 3 + (k + 1) % 3];
+			int * e = &edges[noEdges++ * 4];
+			e[0] = cmmin(a, b);
+			e[1] = cmmax(a, b);
+			e[2] = t;
+			e[3] = a;
+		}
+	}
+	qsort(edges, noEdges, sizeof(int) * 4, compareEdges);
+
+// Classify the edges and constrain the borders and seams
+	int i = 0;
+	while (i < noEdges) {
+		int * e1 = &edges[i * 4];
+		int j = i + 1;
+		while (j < noEdges && edges[j * 4] == e1[0] && edges[j * 4 + 1] == e1[1]) j++;
+		int a = e1[0];
+		int b = e1[1];
+
+		if (j - i == 2) {
+			int * e2 = &edges[(i + 1) * 4];
+			int t1 = e1[2];
+			int t2 = e2[2];
+			if (e1[3] == e2[3]) {
+			// Inconsistent winding
+				kinds[a] |= LE_SIMPLIFIER_BORDER;
+				kinds[b] |= LE_SIMPLIFIER_BORDER;
+				addEdge(t1, a, b);
+			}else if (slots[t1] != slots[t2] ||
+					  texs[corner(t1, a)] != texs[corner(t2, a)] ||
+					  texs[corner(t1, b)] != texs[corner(t2, b)]) {
+				kinds[a] |= LE_SIMPLIFIER_SEAM;
+				kinds[b] |= LE_SIMPLIFIER_SEAM;
+				addEdge(t1, a, b);
+			}
+		}else if (j - i == 1) {
+			kinds[a] |= LE_SIMPLIFIER_BORDER;
+			kinds[b] |= LE_SIMPLIFIER_BORDER;
+			addEdge(e1[2], a, b);
+		}else{
+			kinds[a] |= LE_SIMPLIFIER_LOCKED;
+			kinds[b] |= LE_SIMPLIFIER_LOCKED;
+		}
+		i = j;
+	}
+	delete[] edges;
+}
+
+void LeSimplifier::computeAdjacency()
+{
+// Count then fill the vertex triangle fans
+	memset(adjStart, 0, (noVertexes + 1) * sizeof(int));
+	for (int t = 0; t < noTriangles; t++) {
+		if (removed[t]) continue;
+		for (int k = 0; k < 3; k++)
+			adjStart[tris[t * 3 + k]]++;
+	}
+
+	int sum = 0;
+	for (int v = 0; v <= noVertexes; v++) {
+		sum += adjStart[v];
+		adjStart[v] = sum;
+	}
+
+	for (int t = 0; t < noTriangles; t++) {
+		if (removed[t]) continue;
+		for (int k = 0; k < 3; k++)
+			adjTris[--adjStart[tris[t * 3 + k]]] = t;
+	}
+}
+
+/*****************************************************************************/
+bool LeSimplifier::check(int from, int to, int map[][3], int & noMap)
+{
+// Map the collapsed vertex texture coordinates through the shared triangles
+	int noShared = 0;
+	for (int i = adjStart[from]; i < adjStart[from + 1]; i++) {
+		int t = adjTris[i];
+		int ct = corner(t, to);
+		if (ct < 0) continue;
+		int cf = corner(t, from);
+		int m = findMap(map, noMap, texs[cf], slots[t]);
+		if (m < 0) {
+			if (noMap == LE_SIMPLIFIER_MAX_MAP) return false;
+			map[noMap][0] = texs[cf];
+			map[noMap][1] = slots[t];
+			map[noMap][2] = texs[ct];
+			noMap++;
+		}else if (map[m][2] != texs[ct]) return false;
+		noShared++;
+	}
+	if (!noShared) return false;
+	if ((kinds[from] & LE_SIMPLIFIER_BORDER) && noShared != 1) return false;
+
+// Check the moved triangles (mapped attributes, no flip)
+	int stamp1 = ++stamp;
+	for (int i = adjStart[from]; i < adjStart[from + 1]; i++) {
+		int t = adjTris[i];
+		int * v = &tris[t * 3];
+		for (int k = 0; k < 3; k++)
+			marks[v[k]] = stamp1;
+		if (corner(t, to) >= 0) continue;
+
+		int cf = corner(t, from);
+		if (findMap(map, noMap, texs[cf], slots[t]) < 0) return false;
+
+		LeVertex n1 = faceNormal(t);
+		v[cf - t * 3] = to;
+		LeVertex n2 = faceNormal(t);
+		v[cf - t * 3] = from;
+		if (n1.dot(n2) <= 0.25f) return false;
+	}
+
+// Check the link condition (common neighbours are the shared triangles ones)
+	int stamp2 = ++stamp;
+	int noCommon = 0;
+	for (int i = adjStart[to]; i < adjStart[to + 1]; i++) {
+		int * v = &tris[adjTris[i] * 3];
+		for (int k = 0; k < 3; k++) {
+			if (v[k] == from || v[k] == to) continue;
+			if (marks[v[k]] != stamp1) continue;
+			marks[v[k]] = stamp2;
+			noCommon++;
+		}
+	}
+	return noCommon == noShared;
+}
+
+void LeSimplifier::collapse(int from, int to, int map[][3], int noMap)
+{
+	for (int i = adjStart[from]; i < adjStart[from + 1]; i++) {
+		int t = adjTris[i];
+		if (corner(t, to) >= 0) {
+			removed[t] = 1;
+			noLive--;
+		}else{
+			int cf = corner(t, from);
+			int m = findMap(map, noMap, texs[cf], slots[t]);
+			tris[cf] = to;
+			texs[cf] = map[m][2];
+		}
+		for (int k = 0; k < 3; k++)
+			locks[tris[t * 3 + k]] = pass;
+	}
+	locks[from] = pass;
+	locks[to] = pass;
+
+	for (int i = 0; i < 10; i++)
+		quadrics[to].a[i] += quadrics[from].a[i];
+}
+
+/*****************************************************************************/
+LeMesh * LeSimplifier::extract(const LeMesh * mesh)
+{
+// Compact the remaining vertexes and texture coordinates
+	int * vertexMap = new int[noVertexes];
+	memset(vertexMap, 0xFF, noVertexes * sizeof(int));
+	int * texMap = new int[mesh->noTexCoords + 1];
+	memset(texMap, 0xFF, (mesh->noTexCoords + 1) * sizeof(int));
+
+	int noUsedVertexes = 0;
+	int noUsedTexCoords = 0;
+	for (int t = 0; t < noTriangles; t++) {
+		if (removed[t]) continue;
+		for (int k = 0; k < 3; k++) {
+			int v = tris[t * 3 + k];
+			if (vertexMap[v] < 0) vertexMap[v] = noUsedVertexes++;
+			int c = texs[t * 3 + k];
+			if (c < 0 || c >= mesh->noTexCoords) continue;
+			if (texMap[c] < 0) texMap[c] = noUsedTexCoords++;
+		}
+	}
+
+	LeMesh * result = new LeMesh();
+	result->allocate(noUsedVertexes, noUsedTexCoords, noLive);
+	memcpy(result->name, mesh->name, LE_OBJ_MAX_NAME + 1);
+	result->view = mesh->view;
+	result->pos = mesh->pos;
+	result->scale = mesh->scale;
+	result->angle = mesh->angle;
+
+	for (int v = 0; v < noVertexes; v++)
+		if (vertexMap[v] >= 0) result->vertexes[vertexMap[v]] = vertexes[v];
+	for (int c = 0; c < mesh->noTexCoords; c++) {
+		if (texMap[c] < 0) continue;
+		result->texCoords[texMap[c] * 2 + 0] = mesh->texCoords[c * 2 + 0];
+		result->texCoords[texMap[c] * 2 + 1] = mesh->texCoords[c * 2 + 1];
+	}
+
+// Copy the remaining triangles
+	int n = 0;
+	for (int t = 0; t < noTriangles; t++) {
+		if (removed[t]) continue;
+		for (int k = 0; k < 3; k++) {
+			result->vertexesList[n * 3 + k] = vertexMap[tris[t * 3 + k]];
+			int c = texs[t * 3 + k];
+			result->texCoordsList[n * 3 + k] = c >= 0 && c < mesh->noTexCoords ? texMap[c] : 0;
+		}
+		result->texSlotList[n] = slots[t];
+		if (mesh->colors) result->colors[n] = mesh->colors[t];
+		n++;
+	}
+	delete[] vertexMap;
+	delete[] texMap;
+
+// Compute the derived data
+	if (mesh->normals) result->computeNormals();
+	if (mesh->shades) result->allocateShades();
+	result->computeBounds();
+	result->computePositions();
+	result->computePlanes();
+	return result;
+}
+
+/*****************************************************************************/
+LeVertex LeSimplifier::faceNormal(int t)
+{
+	LeVertex v1 = vertexes[tris[t * 3]];
+	LeVertex v2 = vertexes[tris[t * 3 + 1]];
+	LeVertex v3 = vertexes[tris[t * 3 + 2]];
+	LeVertex n = (v2 - v1).cross(v3 - v1);
+	float len = n.norm();
+	if (len > 0.0f) n = n * (1.0f / len);
+	n.w = len;
+	return n;
+}
+
+void LeSimplifier::addEdge(int t, int a, int b)
+{
+	LeVertex n = faceNormal(t);
+	LeVertex e = vertexes[b] - vertexes[a];
+	LeVertex p = e.cross(n);
+	float len = p.norm();
+	if (len == 0.0f) return;
+	p = p * (1.0f / len);
+	float d = -p.dot(vertexes[a]);
+	float weight = e.dot(e) * borderWeight;
+	addPlane(quadrics[a], p, d, weight);
+	addPlane(quadrics[b], p, d, weight);
+}
+
+int LeSimplifier::corner(int t, int v)
+{
+	int * tri = &tris[t * 3];
+	if (tri[0] == v) return t * 3;
+	if (tri[1] == v) return t * 3 + 1;
+	if (tri[2] == v) return t * 3 + 2;
+	return -1;
+}
+
+int LeSimplifier::findMap(int map[][3], int noMap, int tex, int slot)
+{
+	for (int m = 0; m < noMap; m++)
+		if (map[m][0] == tex && map[m][1] == slot) return m;
+	return -1;
+}
+
+/*****************************************************************************/
+void LeSimplifier::addPlane(Quadric & q, const LeVertex & n, float d, float weight)
+{
+	double x = n.x, y = n.y, z = n.z, w = d;
+	q.a[0] += weight * x * x;
+	q.a[1] += weight * x * y;
+	q.a[2] += weight * x * z;
+	q.a[3] += weight * x * w;
+	q.a[4] += weight * y * y;
+	q.a[5] += weight * y * z;
+	q.a[6] += weight * y * w;
+	q.a[7] += weight * z * z;
+	q.a[8] += weight * z * w;
+	q.a[9] += weight * w * w;
+}
+
+double LeSimplifier::evaluate(const Quadric & q, const LeVertex & v)
+{
+	double x = v.x, y = v.y, z = v.z;
+	return q.a[0] * x * x + 2.0 * q.a[1] * x * y + 2.0 * q.a[2] * x * z + 2.0 * q.a[3] * x
+		 + q.a[4] * y * y + 2.0 * q.a[5] * y * z + 2.0 * q.a[6] * y
+		 + q.a[7] * z * z + 2.0 * q.a[8] * z
+		 + q.a[9];
+}
+
+int LeSimplifier::compareCollapses(const void * a, const void * b)
+{
+	float ca = ((const Collapse *) a)->cost;
+	float cb = ((const Collapse *) b)->cost;
+	if (ca < cb) return -1;
+	if (ca > cb) return 1;
+	return 0;
+}
+
+int LeSimplifier::compareEdges(const void * a, const void * b)
+{
+	const int * ea = (const int *) a;
+	const int * eb = (const int *) b;
+	if (ea[0] != eb[0]) return ea[0] < eb[0] ? -1 : 1;
+	if (ea[1] != eb[1]) return ea[1] < eb[1] ? -1 : 1;
+	return 0;
+}
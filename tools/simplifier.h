@@ -0,0 +1,113 @@
+/**
+	\file simplifier.h
+	\brief LightEngine 3D (tools): Quadric error mesh simplifier
+	\brief All platforms implementation
+	\author Frederic Meslin (fred@fredslab.net)
+	\twitter @marzacdev
+	\website http://fredslab.net
+	\copyright Frederic Meslin 2015 - 2018
+	\version 1.75
+
+	The MIT License (MIT)
+	Copyright (c) 2015-2018 Frdric Meslin
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef SIMPLIFIER_H
+#define SIMPLIFIER_H
+
+#include "../engine/le3d.h"
+#include <stdint.h>
+
+/*****************************************************************************/
+/**
+	\class LeSimplifier
+	\brief Reduce meshes with quadric error edge collapses (texture seams and borders preserved)
+*/
+class LeSimplifier {
+public:
+	LeSimplifier();
+	~LeSimplifier();
+
+	LeMesh * simplify(const LeMesh * mesh, int target);
+	int generate(LeMesh * mesh, LeMeshLOD * lod, LeMesh * levels[], int noLevels, float ratio, float size);
+
+public:
+	float maxError;						/**< Maximum collapse error (squared distance) */
+	float borderWeight;					/**< Weight of the border and seam constraints */
+	float error;						/**< Largest collapse error of the last simplification */
+
+private:
+/** Symmetric 4x4 quadric (upper triangle) */
+	typedef struct {
+		double a[10];
+	} Quadric;
+
+/** Edge collapse candidate */
+	typedef struct {
+		int from;
+		int to;
+		float cost;
+	} Collapse;
+
+	void allocate(const LeMesh * mesh);
+	void deallocate();
+
+	void computeQuadrics();
+	void computeAdjacency();
+
+	bool check(int from, int to, int map[][3], int & noMap);
+	void collapse(int from, int to, int map[][3], int noMap);
+	LeMesh * extract(const LeMesh * mesh);
+
+	LeVertex faceNormal(int t);
+	void addEdge(int t, int a, int b);
+	int corner(int t, int v);
+
+	static int findMap(int map[][3], int noMap, int tex, int slot);
+
+	static void addPlane(Quadric & q, const LeVertex & n, float d, float weight);
+	static double evaluate(const Quadric & q, const LeVertex & v);
+	static int compareCollapses(const void * a, const void * b);
+	static int compareEdges(const void * a, const void * b);
+
+	LeVertex * vertexes;				/**< Vertex positions */
+	Quadric * quadrics;					/**< Vertex quadrics */
+	uint8_t * kinds;					/**< Vertex kinds (border, seam, locked) */
+	int * marks;						/**< Vertex marks (link condition) */
+	int * locks;						/**< Vertex locks (current pass) */
+	int noVertexes;						/**< Number of vertexes */
+
+	int * tris;							/**< Triangle vertex indexes */
+	int * texs;							/**< Triangle texture coordinate indexes */
+	int * slots;						/**< Triangle texture slots */
+	uint8_t * removed;					/**< Triangle removed flags */
+	int noTriangles;					/**< Number of triangles */
+	int noLive;							/**< Number of remaining triangles */
+
+	int * adjStart;						/**< Vertex triangle fans (first entry) */
+	int * adjTris;						/**< Vertex triangle fans (triangle indexes) */
+
+	Collapse * collapses;				/**< Collapse candidates */
+	int stamp;							/**< Current mark stamp */
+	int pass;							/**< Current pass */
+};
+
+#endif